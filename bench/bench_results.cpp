@@ -0,0 +1,139 @@
+#include "bench_results.hpp"
+
+#include "raygun/logging.hpp"
+#include "raygun/raygun.hpp"
+
+using namespace raygun;
+
+namespace {
+
+    // Differences below this are considered noise, regardless of the threshold.
+    constexpr double MIN_REGRESSION_MS = 0.05;
+
+    constexpr std::array<const char*, 2> TIMING_GROUPS = {"cpu", "timers"};
+    constexpr std::array<const char*, 2> COMPARED_PERCENTILES = {"p50", "p99"};
+
+    json statsToJson(const std::map<string, profiling::TimerStats>& stats)
+    {
+        json data = json::object();
+        for(const auto& [name, timer]: stats) {
+            data[name] = timer.toJson();
+        }
+        return data;
+    }
+
+    /// Physics setup of the run, to tell results of different setups apart.
+    json physicsConfigToJson(const Config& config)
+    {
+        const auto broadphase = [&] {
+            switch(config.physicsBroadphase) {
+            case Config::PhysicsBroadphase::SAP: return "sap";
+            case Config::PhysicsBroadphase::MBP: return "mbp";
+            case Config::PhysicsBroadphase::ABP: return "abp";
+            }
+            return "unknown";
+        }();
+
+        return {
+            {"threads", config.physicsThreads},
+            {"broadphase", broadphase},
+            {"solver", config.physicsSolver == Config::PhysicsSolver::TGS ? "tgs" : "pgs"},
+            {"determinism", config.physicsDeterminism},
+            {"overlap", config.physicsOverlap},
+        };
+    }
+
+} // namespace
+
+json resultsToJson(const std::vector<ScenarioResult>& results)
+{
+    json scenarios = json::object();
+    for(const auto& result: results) {
+        scenarios[result.name] = {
+            {"count", result.count},
+            {"frames", result.frames},
+            {"seconds", result.seconds},
+            {"cpu", statsToJson(result.cpu)},
+            {"timers", statsToJson(result.timers)},
+            {"memory", result.memory},
+        };
+    }
+
+    return {
+        {"version", RAYGUN_VERSION},
+        {"device", RG().vc().physicalDeviceProperties.deviceName.data()},
+        {"physics", physicsConfigToJson(RG().config())},
+        {"scenarios", std::move(scenarios)},
+    };
+}
+
+void writeCsv(const fs::path& path, const std::vector<ScenarioResult>& results)
+{
+    std::ofstream out(path);
+    if(!out) {
+        RAYGUN_ERROR("Unable to write {}", path);
+        return;
+    }
+
+    out << "scenario,group,name,count,min,p50,p90,p99,p99.9,max,mean,stddev\n";
+
+    const auto writeGroup = [&](const ScenarioResult& result, const char* group, const std::map<string, profiling::TimerStats>& stats) {
+        for(const auto& [name, timer]: stats) {
+            out << fmt::format("{},{},\"{}\",{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f}\n", result.name, group, name, timer.count(), timer.min(),
+                               timer.percentile(0.5), timer.percentile(0.9), timer.percentile(0.99), timer.percentile(0.999), timer.max(), timer.mean(),
+                               timer.stddev());
+        }
+    };
+
+    for(const auto& result: results) {
+        writeGroup(result, "cpu", result.cpu);
+        writeGroup(result, "timers", result.timers);
+    }
+}
+
+uint32_t compareWithBaseline(const json& baseline, const json& results, double threshold)
+{
+    uint32_t regressions = 0;
+
+    if(baseline.contains("physics") && baseline["physics"] != results["physics"]) {
+        RAYGUN_WARN("Baseline physics setup {} differs from {}", baseline["physics"].dump(), results["physics"].dump());
+    }
+
+    for(const auto& [scenario, current]: results.at("scenarios").items()) {
+        if(!baseline["scenarios"].contains(scenario)) {
+            RAYGUN_WARN("{}: not in baseline", scenario);
+            continue;
+        }
+
+        const auto& base = baseline["scenarios"][scenario];
+        if(base.value("count", 0) != current.value("count", 0)) {
+            RAYGUN_WARN("{}: baseline count {} differs from {}, skipping", scenario, base.value("count", 0), current.value("count", 0));
+            continue;
+        }
+
+        for(const auto group: TIMING_GROUPS) {
+            if(!base.contains(group)) continue;
+
+            for(const auto& [name, stats]: current.at(group).items()) {
+                if(!base[group].contains(name)) continue;
+
+                for(const auto percentile: COMPARED_PERCENTILES) {
+                    const auto before = base[group][name].value(percentile, 0.0);
+                    const auto after = stats.value(percentile, 0.0);
+
+                    if(after > before * (1.0 + threshold) && after - before > MIN_REGRESSION_MS) {
+                        RAYGUN_WARN("Regression {} / {} / {} {}: {:.3f} ms -> {:.3f} ms ({:+.1f}%)", scenario, group, name, percentile, before, after,
+                                    before > 0.0 ? (after / before - 1.0) * 100.0 : 100.0);
+                        regressions++;
+                    }
+                }
+            }
+        }
+    }
+
+    if(regressions == 0) {
+        RAYGUN_INFO("No regressions against baseline");
+    }
+
+    return regressions;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "bench_scene.hpp"
+
+raygun::json resultsToJson(const std::vector<ScenarioResult>& results);
+
+/// One row per scenario and measured timing.
+void writeCsv(const raygun::fs::path& path, const std::vector<ScenarioResult>& results);
+
+/// Flags timings whose p50 or p99 exceed the baseline by more than the
+/// given fraction. Returns the number of regressions.
+uint32_t compareWithBaseline(const raygun::json& baseline, const raygun::json& results, double threshold);
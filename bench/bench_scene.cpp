@@ -0,0 +1,104 @@
+#include "bench_scene.hpp"
+
+#include "raygun/raygun.hpp"
+
+using namespace raygun;
+
+namespace {
+
+    /// Resident and peak resident set size of the process, where available.
+    std::map<string, double> processMemory()
+    {
+        std::map<string, double> memory;
+
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+
+        string line;
+        while(std::getline(status, line)) {
+            // Values are given in kB.
+            if(line.rfind("VmRSS:", 0) == 0) {
+                memory["residentMiB"] = std::stod(line.substr(6)) / 1024.0;
+            }
+            else if(line.rfind("VmHWM:", 0) == 0) {
+                memory["peakResidentMiB"] = std::stod(line.substr(6)) / 1024.0;
+            }
+        }
+#endif
+
+        return memory;
+    }
+
+} // namespace
+
+BenchScene::BenchScene(string_view name, uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+    : m_count(count)
+    , m_options(options)
+    , m_onFinished(std::move(onFinished))
+{
+    m_result.name = name;
+    m_result.count = count;
+}
+
+void BenchScene::preSimulation()
+{
+    const auto measureBegin = m_options.warmupFrames;
+    const auto measureEnd = m_options.warmupFrames + m_options.frames;
+
+    if(m_frame == measureBegin) {
+        RG().profiler().resetStatistics();
+        m_measureStart = Clock::now();
+    }
+    else if(m_frame > measureBegin && m_frame <= measureEnd) {
+        // Zones are available one frame later.
+        measureFrame();
+    }
+
+    if(m_frame == measureEnd) {
+        finish();
+    }
+
+    // The camera path only depends on the frame number.
+    const auto measuredFrame = m_frame < measureBegin ? 0 : m_frame - measureBegin;
+    const auto angle = m_orbit.startAngle + glm::two_pi<float>() * m_orbit.turns * (float)measuredFrame / (float)std::max(m_options.frames, 1u);
+
+    camera->moveTo(m_orbit.target + vec3{std::cos(angle) * m_orbit.radius, m_orbit.height, std::sin(angle) * m_orbit.radius});
+    camera->lookAt(m_orbit.target);
+
+    m_frame++;
+}
+
+void BenchScene::measureFrame()
+{
+    m_frameZoneTimes.clear();
+
+    for(const auto& thread: RG().profiler().frameZones()) {
+        if(thread.threadName != "Main") continue;
+
+        for(const auto& event: thread.events) {
+            m_frameZoneTimes[event.name] += (double)(event.endNs - event.startNs) / (1000.0 * 1000.0);
+        }
+    }
+
+    for(const auto& [name, ms]: m_frameZoneTimes) {
+        m_result.cpu[name].add(ms);
+    }
+}
+
+void BenchScene::finish()
+{
+    m_result.frames = m_options.frames;
+    m_result.seconds = std::chrono::duration<double>(Clock::now() - m_measureStart).count();
+
+    for(uint32_t i = 0; i < (uint32_t)TimerID::Count; ++i) {
+        const auto& stats = RG().profiler().stats((TimerID)i);
+        if(stats.count() > 0) {
+            m_result.timers[Profiler::timerName((TimerID)i)] = stats;
+        }
+    }
+
+    m_result.memory = processMemory();
+    m_result.memory["frameArenaPeakKiB"] = (double)RG().frameArena().peakBytes() / 1024.0;
+
+    m_onFinished(std::move(m_result));
+}
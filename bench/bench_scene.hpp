@@ -0,0 +1,71 @@
+#pragma once
+
+#include "raygun/profiler_stats.hpp"
+#include "raygun/scene.hpp"
+
+struct BenchOptions {
+    uint32_t warmupFrames = 60;
+    uint32_t frames = 600;
+
+    /// Overrides the scenario's default object count when set.
+    uint32_t count = 0;
+};
+
+/// Measurements of one scenario run, all times in milliseconds.
+struct ScenarioResult {
+    raygun::string name;
+    uint32_t count = 0;
+    uint32_t frames = 0;
+    double seconds = 0.0;
+
+    /// Per zone name of the main thread, summed per frame.
+    std::map<raygun::string, raygun::profiling::TimerStats> cpu;
+
+    /// Per profiler timer, covering total frame, CPU and GPU times.
+    std::map<raygun::string, raygun::profiling::TimerStats> timers;
+
+    std::map<raygun::string, double> memory;
+};
+
+/// Base of all benchmark scenarios. Moves the camera along a fixed orbit,
+/// skips the warm-up frames and measures the following ones. Once done,
+/// onFinished is invoked with the result.
+class BenchScene : public raygun::Scene {
+  public:
+    using FinishCallback = std::function<void(ScenarioResult)>;
+
+    BenchScene(raygun::string_view name, uint32_t count, const BenchOptions& options, FinishCallback onFinished);
+
+    void preSimulation() override;
+
+  protected:
+    struct CameraOrbit {
+        raygun::vec3 target = raygun::zero();
+        float radius = 20.0f;
+        float height = 10.0f;
+
+        /// In radians, 0 is on the positive x axis.
+        float startAngle = 0.0f;
+
+        /// Full turns over the measured frames.
+        float turns = 1.0f;
+    };
+
+    CameraOrbit m_orbit;
+
+    const uint32_t m_count;
+
+  private:
+    void measureFrame();
+    void finish();
+
+    BenchOptions m_options;
+    FinishCallback m_onFinished;
+
+    uint32_t m_frame = 0;
+
+    ScenarioResult m_result;
+    raygun::Clock::time_point m_measureStart;
+
+    std::map<raygun::string, double> m_frameZoneTimes;
+};
@@ -0,0 +1,225 @@
+#include "raygun/logging.hpp"
+#include "raygun/raygun.hpp"
+
+#include "bench_results.hpp"
+#include "scenarios.hpp"
+
+using namespace raygun;
+
+namespace {
+
+    /// Benchmarks run in a hidden window without vsync, advancing the
+    /// simulation by a fixed amount every frame.
+    UniqueConfig benchConfig()
+    {
+        auto config = std::make_unique<Config>();
+        config->fullscreen = Config::Fullscreen::Window;
+        config->presentMode = Config::PresentMode::Immediate;
+        config->width = 1280;
+        config->height = 720;
+        config->hiddenWindow = true;
+        config->fixedTimeDelta = 1.0 / 60.0;
+        config->effectVolume = 0.0;
+        config->musicVolume = 0.0;
+        return config;
+    }
+
+    struct Arguments {
+        BenchOptions options;
+
+        UniqueConfig config = benchConfig();
+
+        std::vector<const Scenario*> scenarios;
+
+        fs::path jsonPath = "bench_results.json";
+        fs::path csvPath;
+        fs::path baselinePath;
+        double threshold = 0.1;
+    };
+
+    void printUsage()
+    {
+        fmt::print("Usage: raygun_bench [options]\n"
+                   "  --scenario <name>    Run the given scenario, may be repeated (default: all)\n"
+                   "  --frames <n>         Measured frames per scenario (default: 600)\n"
+                   "  --warmup <n>         Frames skipped before measuring (default: 60)\n"
+                   "  --count <n>          Object count, overriding the scenario default\n"
+                   "  --threads <n>        Physics worker threads, -1 for one per core (default: 2)\n"
+                   "  --broadphase <type>  Physics broadphase: sap, mbp or abp (default: abp)\n"
+                   "  --solver <type>      Physics solver: pgs or tgs (default: pgs)\n"
+                   "  --determinism <0|1>  Enhanced physics determinism (default: 1)\n"
+                   "  --overlap <0|1>      Overlap physics with audio and rendering (default: 0)\n"
+                   "  --json <file>        Write results as JSON (default: bench_results.json)\n"
+                   "  --csv <file>         Write results as CSV\n"
+                   "  --baseline <file>    Compare against a previous JSON result, exits with 1 on regressions\n"
+                   "  --threshold <frac>   Allowed slowdown against the baseline (default: 0.1)\n"
+                   "  --list               List scenarios\n");
+    }
+
+    std::optional<Arguments> parseArguments(int argc, char* argv[])
+    {
+        Arguments args;
+
+        for(int i = 1; i < argc; ++i) {
+            const string_view arg = argv[i];
+            const auto value = [&]() -> string_view {
+                if(i + 1 >= argc) {
+                    fmt::print(stderr, "Missing value for {}\n", arg);
+                    std::exit(2);
+                }
+                return argv[++i];
+            };
+
+            if(arg == "--scenario") {
+                const auto name = value();
+                const auto scenario = findScenario(name);
+                if(!scenario) {
+                    fmt::print(stderr, "Unknown scenario: {}\n", name);
+                    return {};
+                }
+                args.scenarios.push_back(scenario);
+            }
+            else if(arg == "--frames") {
+                args.options.frames = (uint32_t)std::stoul(string(value()));
+            }
+            else if(arg == "--warmup") {
+                args.options.warmupFrames = (uint32_t)std::stoul(string(value()));
+            }
+            else if(arg == "--count") {
+                args.options.count = (uint32_t)std::stoul(string(value()));
+            }
+            else if(arg == "--threads") {
+                args.config->physicsThreads = std::stoi(string(value()));
+            }
+            else if(arg == "--broadphase") {
+                const auto type = value();
+                if(type == "sap") {
+                    args.config->physicsBroadphase = Config::PhysicsBroadphase::SAP;
+                }
+                else if(type == "mbp") {
+                    args.config->physicsBroadphase = Config::PhysicsBroadphase::MBP;
+                }
+                else if(type == "abp") {
+                    args.config->physicsBroadphase = Config::PhysicsBroadphase::ABP;
+                }
+                else {
+                    fmt::print(stderr, "Unknown broadphase: {}\n", type);
+                    return {};
+                }
+            }
+            else if(arg == "--solver") {
+                const auto type = value();
+                if(type == "pgs") {
+                    args.config->physicsSolver = Config::PhysicsSolver::PGS;
+                }
+                else if(type == "tgs") {
+                    args.config->physicsSolver = Config::PhysicsSolver::TGS;
+                }
+                else {
+                    fmt::print(stderr, "Unknown solver: {}\n", type);
+                    return {};
+                }
+            }
+            else if(arg == "--determinism") {
+                args.config->physicsDeterminism = value() != "0";
+            }
+            else if(arg == "--overlap") {
+                args.config->physicsOverlap = value() != "0";
+            }
+            else if(arg == "--json") {
+                args.jsonPath = value();
+            }
+            else if(arg == "--csv") {
+                args.csvPath = value();
+            }
+            else if(arg == "--baseline") {
+                args.baselinePath = value();
+            }
+            else if(arg == "--threshold") {
+                args.threshold = std::stod(string(value()));
+            }
+            else if(arg == "--list") {
+                for(const auto& scenario: scenarios()) {
+                    fmt::print("{:10} {} (count {})\n", scenario.name, scenario.description, scenario.defaultCount);
+                }
+                std::exit(0);
+            }
+            else {
+                printUsage();
+                return {};
+            }
+        }
+
+        if(args.scenarios.empty()) {
+            for(const auto& scenario: scenarios()) {
+                args.scenarios.push_back(&scenario);
+            }
+        }
+
+        return args;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto args = parseArguments(argc, argv);
+    if(!args) return 2;
+
+    Raygun rg("Raygun Bench", std::move(args->config));
+
+    std::vector<ScenarioResult> results;
+    size_t next = 0;
+
+    std::function<void()> runNext = [&] {
+        if(next == args->scenarios.size()) {
+            rg.quit();
+            return;
+        }
+
+        const auto& scenario = *args->scenarios[next++];
+        const auto count = args->options.count ? args->options.count : scenario.defaultCount;
+
+        RAYGUN_INFO("Running scenario {} (count {}, {} frames)", scenario.name, count, args->options.frames);
+
+        rg.loadScene(scenario.create(count, args->options, [&](ScenarioResult result) {
+            RAYGUN_INFO("Scenario {} done: frame p50 {:.2f} ms, p99 {:.2f} ms", result.name, result.timers["Total"].percentile(0.5),
+                        result.timers["Total"].percentile(0.99));
+
+            results.push_back(std::move(result));
+            runNext();
+        }));
+    };
+
+    runNext();
+    rg.loop();
+
+    const auto data = resultsToJson(results);
+
+    {
+        std::ofstream out(args->jsonPath);
+        out << data.dump(2);
+        RAYGUN_INFO("Results written to {}", args->jsonPath);
+    }
+
+    if(!args->csvPath.empty()) {
+        writeCsv(args->csvPath, results);
+    }
+
+    if(!args->baselinePath.empty()) {
+        std::ifstream in(args->baselinePath);
+        if(!in) {
+            RAYGUN_ERROR("Unable to read baseline {}", args->baselinePath);
+            return 2;
+        }
+
+        json baseline;
+        in >> baseline;
+
+        if(compareWithBaseline(baseline, data, args->threshold) > 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
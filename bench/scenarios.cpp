@@ -0,0 +1,462 @@
+#include "scenarios.hpp"
+
+#include "raygun/raygun.hpp"
+#include "raygun/ui/ui.hpp"
+
+using namespace raygun;
+using namespace raygun::physics;
+using namespace physx;
+
+namespace {
+
+    /// Loads the ball model once, all instances share it.
+    std::shared_ptr<render::Model> ballModel()
+    {
+        auto ball = RG().resourceManager().loadEntity("ball");
+        return ball->children().at(0)->model;
+    }
+
+    std::shared_ptr<Entity> loadLevel()
+    {
+        auto level = RG().resourceManager().loadEntity("room");
+        level->forEachEntity([](Entity& entity) {
+            if(entity.model) {
+                RG().physicsSystem().attachRigidStatic(entity, GeometryType::TriangleMesh);
+            }
+        });
+        return level;
+    }
+
+    std::shared_ptr<Entity> groundPlane(PxMaterial& material)
+    {
+        auto ground = std::make_shared<Entity>("ground");
+        ground->setPhysicsActor(wrapUnique(PxCreatePlane(RG().physicsSystem().physics(), PxPlane(0.0f, 1.0f, 0.0f, 0.0f), material)));
+        return ground;
+    }
+
+    /// Many instances of one model on a grid, all spinning. Stresses
+    /// transform updates and the top level AS.
+    class EntitiesScene : public BenchScene {
+      public:
+        EntitiesScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("entities", count, options, std::move(onFinished))
+        {
+            const auto model = ballModel();
+
+            const auto side = (uint32_t)std::ceil(std::sqrt((double)count));
+            const auto offset = (float)side * SPACING / 2.0f;
+
+            for(uint32_t i = 0; i < count; ++i) {
+                auto entity = std::make_shared<Entity>("instance");
+                entity->model = model;
+                entity->moveTo({(float)(i % side) * SPACING - offset, 0.0f, (float)(i / side) * SPACING - offset});
+
+                root->addChild(entity);
+                m_instances.push_back(std::move(entity));
+            }
+
+            m_orbit.radius = offset * 1.5f + 5.0f;
+            m_orbit.height = offset * 0.5f + 5.0f;
+        }
+
+        void update(double timeDelta) override
+        {
+            for(auto& instance: m_instances) {
+                instance->rotate((float)timeDelta, UP);
+            }
+        }
+
+      private:
+        static constexpr float SPACING = 1.5f;
+
+        std::vector<std::shared_ptr<Entity>> m_instances;
+    };
+
+    /// Loads the ball model separately for every entity, stressing vertex
+    /// buffers and bottom level AS.
+    class ModelsScene : public BenchScene {
+      public:
+        ModelsScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("models", count, options, std::move(onFinished))
+        {
+            root->addChild(RG().resourceManager().loadEntity("room"));
+
+            for(uint32_t i = 0; i < count; ++i) {
+                const auto angle = glm::two_pi<float>() * (float)i / (float)count;
+
+                auto ball = RG().resourceManager().loadEntity("ball");
+                ball->moveTo({std::cos(angle) * 4.0f, 1.0f + (float)(i % 4), std::sin(angle) * 4.0f});
+                root->addChild(ball);
+            }
+
+            m_orbit.radius = 12.0f;
+            m_orbit.height = 8.0f;
+        }
+    };
+
+    /// Balls dropped as a pile into the room.
+    class PhysicsScene : public BenchScene {
+      public:
+        PhysicsScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("physics", count, options, std::move(onFinished))
+        {
+            root->addChild(loadLevel());
+
+            const auto model = ballModel();
+
+            constexpr uint32_t LAYER_SIDE = 8;
+            for(uint32_t i = 0; i < count; ++i) {
+                const auto layer = i / (LAYER_SIDE * LAYER_SIDE);
+                const auto x = (float)(i % LAYER_SIDE) - LAYER_SIDE / 2.0f;
+                const auto z = (float)((i / LAYER_SIDE) % LAYER_SIDE) - LAYER_SIDE / 2.0f;
+
+                auto ball = std::make_shared<Entity>("ball");
+                ball->model = model;
+                ball->moveTo({x, 2.0f + (float)layer, z});
+                RG().physicsSystem().attachRigidDynamic(*ball, false, GeometryType::Sphere);
+
+                root->addChild(ball);
+            }
+
+            m_orbit.radius = 14.0f;
+            m_orbit.height = 10.0f;
+        }
+    };
+
+    /// Spheres resting on a plane, most of them asleep. A few are kicked
+    /// every frame, so the cost should scale with the moving ones.
+    class SleepingScene : public BenchScene {
+      public:
+        SleepingScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("sleeping", count, options, std::move(onFinished))
+            , m_groundMaterial(wrapUnique(RG().physicsSystem().physics().createMaterial(0.8f, 0.8f, 0.6f)))
+        {
+            root->addChild(groundPlane(*m_groundMaterial));
+
+            const auto model = ballModel();
+            const auto radius = model->mesh->width() / 2.0f;
+            const auto spacing = radius * 3.0f;
+
+            const auto side = (uint32_t)std::ceil(std::sqrt((double)count));
+            const auto offset = (float)side * spacing / 2.0f;
+
+            for(uint32_t i = 0; i < count; ++i) {
+                auto ball = std::make_shared<Entity>("ball");
+                ball->model = model;
+                ball->moveTo({(float)(i % side) * spacing - offset, radius, (float)(i / side) * spacing - offset});
+                RG().physicsSystem().attachRigidDynamic(*ball, false, GeometryType::Sphere);
+
+                m_bodies.push_back(ball->physicsActor()->is<PxRigidDynamic>());
+                root->addChild(ball);
+            }
+
+            m_orbit.radius = offset * 1.2f + 5.0f;
+            m_orbit.height = offset * 0.5f + 5.0f;
+        }
+
+        void update(double) override
+        {
+            const auto kicks = std::max<size_t>(m_bodies.size() / KICKED_FRACTION, 1);
+
+            for(size_t i = 0; i < kicks && !m_bodies.empty(); ++i) {
+                m_nextKick = (m_nextKick + 1) % m_bodies.size();
+                m_bodies[m_nextKick]->addForce({0.0f, 3.0f, 0.0f}, PxForceMode::eVELOCITY_CHANGE);
+            }
+        }
+
+      private:
+        /// One in this many bodies is kicked per simulation step.
+        static constexpr size_t KICKED_FRACTION = 200;
+
+        UniqueMaterial m_groundMaterial;
+
+        std::vector<PxRigidDynamic*> m_bodies;
+        size_t m_nextKick = 0;
+    };
+
+    /// Balls constantly spawned into the room while the oldest ones are
+    /// removed, stressing physics actor registration.
+    class ChurnScene : public BenchScene {
+      public:
+        ChurnScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("churn", count, options, std::move(onFinished)), m_model(ballModel())
+        {
+            root->addChild(loadLevel());
+
+            m_orbit.radius = 14.0f;
+            m_orbit.height = 10.0f;
+        }
+
+        void update(double) override
+        {
+            const auto churn = std::max<uint32_t>(m_count / CHURN_FRACTION, 1);
+
+            for(uint32_t i = 0; i < churn; ++i) {
+                auto ball = std::make_shared<Entity>("ball");
+                ball->model = m_model;
+                ball->moveTo({(float)(m_spawned % 8) - 4.0f, 6.0f, (float)((m_spawned / 8) % 8) - 4.0f});
+                RG().physicsSystem().attachRigidDynamic(*ball, false, GeometryType::Sphere);
+
+                root->addChild(ball);
+                m_balls.push_back(std::move(ball));
+                m_spawned++;
+            }
+
+            while(m_balls.size() > m_count) {
+                root->removeChild(m_balls.front());
+                m_balls.pop_front();
+            }
+        }
+
+      private:
+        /// One in this many balls is replaced per simulation step.
+        static constexpr uint32_t CHURN_FRACTION = 10;
+
+        std::shared_ptr<render::Model> m_model;
+
+        std::deque<std::shared_ptr<Entity>> m_balls;
+        uint32_t m_spawned = 0;
+    };
+
+    /// Base of the physics stress scenarios. Bodies are not rendered, so the
+    /// physics zones dominate the frame; count is the number of bodies.
+    class PhysicsStressScene : public BenchScene {
+      public:
+        PhysicsStressScene(string_view name, uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene(name, count, options, std::move(onFinished))
+            , m_material(wrapUnique(RG().physicsSystem().physics().createMaterial(0.6f, 0.6f, 0.1f)))
+        {
+            root->addChild(groundPlane(*m_material));
+        }
+
+      protected:
+        static constexpr float DENSITY = 10.0f;
+
+        UniqueMaterial m_material;
+
+        PxRigidDynamic& addBody(string_view name, const vec3& position, const PxGeometry& geometry)
+        {
+            const auto body = PxCreateDynamic(RG().physicsSystem().physics(), PxTransform(toVec3(position)), geometry, *m_material, DENSITY);
+            RAYGUN_ASSERT(body);
+
+            auto entity = std::make_shared<Entity>(name);
+            entity->moveTo(position);
+            entity->setPhysicsActor(wrapUnique(body));
+            root->addChild(entity);
+
+            return *body;
+        }
+
+        /// Side length of a square grid holding count elements.
+        static uint32_t gridSide(uint32_t count) { return (uint32_t)std::ceil(std::sqrt((double)count)); }
+    };
+
+    /// Towers of boxes on a grid, settling and falling asleep. Stresses the
+    /// solver with many persistent contacts.
+    class StacksScene : public PhysicsStressScene {
+      public:
+        StacksScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : PhysicsStressScene("stacks", count, options, std::move(onFinished))
+        {
+            const auto stacks = std::max<uint32_t>(count / STACK_HEIGHT, 1);
+            const auto side = gridSide(stacks);
+            const auto offset = (float)side * SPACING / 2.0f;
+
+            const PxBoxGeometry box(HALF_EXTENT, HALF_EXTENT, HALF_EXTENT);
+
+            for(uint32_t i = 0; i < count; ++i) {
+                const auto stack = i / STACK_HEIGHT;
+                const auto level = i % STACK_HEIGHT;
+                const vec3 position = {(float)(stack % side) * SPACING - offset, HALF_EXTENT * (2.0f * (float)level + 1.0f),
+                                       (float)(stack / side) * SPACING - offset};
+                addBody("box", position, box);
+            }
+
+            m_orbit.radius = offset * 1.2f + 10.0f;
+            m_orbit.height = offset * 0.5f + 10.0f;
+        }
+
+      private:
+        static constexpr uint32_t STACK_HEIGHT = 10;
+        static constexpr float HALF_EXTENT = 0.25f;
+        static constexpr float SPACING = 1.0f;
+    };
+
+    /// Boxes and spheres raining onto one spot, all of them moving and
+    /// colliding. Stresses the broadphase and contact generation.
+    class PileScene : public PhysicsStressScene {
+      public:
+        PileScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : PhysicsStressScene("pile", count, options, std::move(onFinished))
+        {
+            const auto layer = gridSide(std::min(count, MAX_LAYER_SIZE));
+            const auto offset = (float)layer * SPACING / 2.0f;
+
+            const PxBoxGeometry box(RADIUS, RADIUS, RADIUS);
+            const PxSphereGeometry sphere(RADIUS);
+
+            for(uint32_t i = 0; i < count; ++i) {
+                const auto height = 2.0f + (float)(i / (layer * layer)) * SPACING;
+                const vec3 position = {(float)(i % layer) * SPACING - offset, height, (float)((i / layer) % layer) * SPACING - offset};
+
+                if(i % 2) {
+                    addBody("box", position, box);
+                }
+                else {
+                    addBody("sphere", position, sphere);
+                }
+            }
+
+            m_orbit.radius = offset * 3.0f + 10.0f;
+            m_orbit.height = offset + 10.0f;
+        }
+
+      private:
+        static constexpr uint32_t MAX_LAYER_SIZE = 400;
+        static constexpr float RADIUS = 0.2f;
+        static constexpr float SPACING = 0.5f;
+    };
+
+    /// Chains of capsules connected by limited spherical joints, dropped onto
+    /// the ground, behaving similar to ragdolls. Stresses joint solving.
+    class ChainsScene : public PhysicsStressScene {
+      public:
+        ChainsScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : PhysicsStressScene("chains", count, options, std::move(onFinished))
+        {
+            auto& physics = RG().physicsSystem().physics();
+
+            // Capsules extend along the x axis, so do the chains.
+            const PxCapsuleGeometry capsule(RADIUS, HALF_LENGTH);
+            const auto linkLength = 2.0f * (HALF_LENGTH + RADIUS);
+            const auto chainLength = linkLength * (float)CHAIN_LENGTH;
+
+            const auto chains = std::max<uint32_t>(count / CHAIN_LENGTH, 1);
+            const auto side = gridSide(chains);
+            const auto offsetX = (float)side * (chainLength + CHAIN_SPACING) / 2.0f;
+            const auto offsetZ = (float)side * CHAIN_SPACING / 2.0f;
+
+            for(uint32_t chain = 0; chain < chains; ++chain) {
+                const vec3 start = {(float)(chain % side) * (chainLength + CHAIN_SPACING) - offsetX, 2.0f + (float)(chain % 3),
+                                    (float)(chain / side) * CHAIN_SPACING - offsetZ};
+
+                PxRigidDynamic* previous = nullptr;
+                for(uint32_t link = 0; link < CHAIN_LENGTH; ++link) {
+                    auto& body = addBody("link", start + vec3{(float)link * linkLength, 0.0f, 0.0f}, capsule);
+
+                    if(previous) {
+                        auto joint = PxSphericalJointCreate(physics, previous, PxTransform(PxVec3(linkLength / 2.0f, 0.0f, 0.0f)), &body,
+                                                            PxTransform(PxVec3(-linkLength / 2.0f, 0.0f, 0.0f)));
+                        joint->setLimitCone(PxJointLimitCone(glm::quarter_pi<float>(), glm::quarter_pi<float>()));
+                        joint->setSphericalJointFlag(PxSphericalJointFlag::eLIMIT_ENABLED, true);
+                        m_joints.push_back(wrapUnique(joint));
+                    }
+
+                    previous = &body;
+                }
+            }
+
+            m_orbit.radius = offsetX * 1.2f + 10.0f;
+            m_orbit.height = offsetX * 0.5f + 10.0f;
+        }
+
+      private:
+        static constexpr uint32_t CHAIN_LENGTH = 16;
+        static constexpr float RADIUS = 0.1f;
+        static constexpr float HALF_LENGTH = 0.15f;
+        static constexpr float CHAIN_SPACING = 1.0f;
+
+        std::vector<UniqueHandle<PxSphericalJoint>> m_joints;
+    };
+
+    /// Batched raycasts in random directions from the middle of the room.
+    /// Divide count by the "Raycasts" zone time for queries per second.
+    class RaycastScene : public BenchScene {
+      public:
+        RaycastScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("raycasts", count, options, std::move(onFinished)), m_rays(count), m_hits(count)
+        {
+            root->addChild(loadLevel());
+
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+            for(auto& ray: m_rays) {
+                ray.origin = {distribution(random), 1.5f + distribution(random), distribution(random)};
+                ray.direction = glm::normalize(vec3{distribution(random), distribution(random), distribution(random)} + vec3{0.0f, 0.0f, 0.001f});
+                ray.maxDistance = 50.0f;
+            }
+
+            m_orbit.radius = 12.0f;
+            m_orbit.height = 8.0f;
+        }
+
+        void update(double) override { RG().physicsSystem().raycast(m_rays.data(), m_hits.data(), m_rays.size()); }
+
+      private:
+        std::vector<Ray> m_rays;
+        std::vector<QueryHit> m_hits;
+    };
+
+    /// Grid of test windows, each with buttons, a slider, checkboxes and
+    /// text, all animated on spawn.
+    class UIScene : public BenchScene {
+      public:
+        UIScene(uint32_t count, const BenchOptions& options, FinishCallback onFinished)
+            : BenchScene("ui", count, options, std::move(onFinished))
+            , m_uiFactory(RG().resourceManager().loadFont("NotoSans"))
+        {
+            const auto side = (uint32_t)std::ceil(std::sqrt((double)count));
+
+            for(uint32_t i = 0; i < count; ++i) {
+                auto window = ui::uiTestWindow(m_uiFactory);
+                window->moveTo({((float)(i % side) - side / 2.0f) * 2.5f, ((float)(i / side) - side / 2.0f) * 2.0f, 0.0f});
+                root->addChild(window);
+            }
+
+            m_orbit.radius = (float)side * 2.5f + 4.0f;
+            m_orbit.height = 0.0f;
+            m_orbit.startAngle = glm::half_pi<float>() - 0.3f;
+            m_orbit.turns = 0.1f;
+        }
+
+      private:
+        ui::Factory m_uiFactory;
+    };
+
+    template<typename T>
+    Scenario scenario(const char* name, const char* description, uint32_t defaultCount)
+    {
+        return {name, description, defaultCount, [](uint32_t count, const BenchOptions& options, BenchScene::FinishCallback onFinished) {
+                    return std::make_unique<T>(count, options, std::move(onFinished));
+                }};
+    }
+
+} // namespace
+
+const std::vector<Scenario>& scenarios()
+{
+    static const std::vector<Scenario> scenarios = {
+        scenario<EntitiesScene>("entities", "Instances of one model on a grid, spinning", 1000),
+        scenario<ModelsScene>("models", "Separately loaded models", 64),
+        scenario<PhysicsScene>("physics", "Pile of dynamic spheres", 500),
+        scenario<SleepingScene>("sleeping", "Mostly sleeping spheres on a plane, a few kicked every step", 10000),
+        scenario<ChurnScene>("churn", "Balls spawned and removed every step", 500),
+        scenario<StacksScene>("stacks", "Towers of boxes settling on a plane", 2000),
+        scenario<PileScene>("pile", "Boxes and spheres dropped onto one spot", 5000),
+        scenario<ChainsScene>("chains", "Jointed capsule chains dropped onto a plane", 2000),
+        scenario<RaycastScene>("raycasts", "Batched raycasts against the room", 10000),
+        scenario<UIScene>("ui", "Grid of animated UI windows", 32),
+    };
+
+    return scenarios;
+}
+
+const Scenario* findScenario(string_view name)
+{
+    for(const auto& scenario: scenarios()) {
+        if(name == scenario.name) return &scenario;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "bench_scene.hpp"
+
+struct Scenario {
+    const char* name;
+    const char* description;
+    uint32_t defaultCount;
+
+    std::function<raygun::UniqueScene(uint32_t count, const BenchOptions& options, BenchScene::FinishCallback onFinished)> create;
+};
+
+const std::vector<Scenario>& scenarios();
+
+const Scenario* findScenario(raygun::string_view name);
@@ -22,7 +22,7 @@ Ball::Ball() : Entity("Ball", RG().resourceManager().entityLoadPath("ball")), m_
     RG().physicsSystem().attachRigidDynamic(*this, false, GeometryType::Sphere);
 
     // our default physics actor is not enough, we also need to adjust its mass.
-    auto rigidBody = dynamic_cast<PxRigidDynamic*>(physicsActor.get());
+    auto rigidBody = dynamic_cast<PxRigidDynamic*>(physicsActor());
     RAYGUN_ASSERT(rigidBody);
     PxRigidBodyExt::updateMassAndInertia(*rigidBody, 50.0f);
 }
@@ -34,7 +34,7 @@ void Ball::update()
     // We do this here for simplicity. One could also grab the contact
     // information from the physics engine.
 
-    auto rigidBody = dynamic_cast<PxRigidDynamic*>(physicsActor.get());
+    auto rigidBody = dynamic_cast<PxRigidDynamic*>(physicsActor());
     RAYGUN_ASSERT(rigidBody);
 
     const auto velocity = toVec3(rigidBody->getLinearVelocity());
@@ -50,7 +50,7 @@ void ExampleScene::processInput(raygun::input::Input input, double timeDelta)
 
     const auto strength = 2000.0 * timeDelta;
 
-    auto rigidDynamic = dynamic_cast<physx::PxRigidDynamic*>(m_ball->physicsActor.get());
+    auto rigidDynamic = dynamic_cast<physx::PxRigidDynamic*>(m_ball->physicsActor());
     RAYGUN_ASSERT(rigidDynamic);
     rigidDynamic->addTorque((float)strength * physx::PxVec3(inputDir.x, 0.f, inputDir.y), physx::PxForceMode::eIMPULSE);
 }
@@ -0,0 +1,20 @@
+#include "pch_shim.hpp"
+#include "raygun/transform_batch.hpp"
+#include <cstdio>
+#include <vector>
+#include <random>
+using namespace raygun;
+int main(){
+  std::mt19937 r(1); std::uniform_real_distribution<float> d(-3,3);
+  const size_t N=37; std::vector<Transform> p(N), l(N), o(N);
+  for(size_t i=0;i<N;i++){ for(auto* t: {&p[i],&l[i]}){ t->position={d(r),d(r),d(r)}; t->rotation=glm::angleAxis(d(r), glm::normalize(vec3{d(r),d(r),d(r)})); t->scaling={1+0.1f*d(r),1+0.1f*d(r),1+0.1f*d(r)};}}
+  struct Inst{float m[3][4]; uint32_t pad[4];}; std::vector<Inst> inst(N);
+  composeMatrices(p.data(), l.data(), &inst[0].m[0][0], sizeof(Inst), N);
+  composeTransforms(p.data(), l.data(), o.data(), N);
+  float maxErr=0, maxErrT=0;
+  for(size_t i=0;i<N;i++){ auto ref = glm::transpose((p[i]*l[i]).toMat4()); const float* rm=&ref[0][0];
+    for(int k=0;k<12;k++) maxErr=std::max(maxErr, std::abs(rm[k]-(&inst[i].m[0][0])[k]));
+    auto rt=p[i]*l[i]; maxErrT=std::max({maxErrT, glm::length(rt.position-o[i].position), std::abs(glm::dot(rt.rotation,o[i].rotation))<1?1-std::abs(glm::dot(rt.rotation,o[i].rotation)):0.f, glm::length(rt.scaling-o[i].scaling)});
+  }
+  printf("%s maxErr matrices %g transforms %g\n", transformBatchIsa(), maxErr, maxErrT);
+}
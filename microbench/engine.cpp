@@ -0,0 +1,32 @@
+#include "engine.hpp"
+
+using namespace raygun;
+
+namespace microbench {
+
+namespace {
+    std::unique_ptr<Raygun> instance;
+}
+
+Raygun& engine()
+{
+    if(!instance) {
+        auto config = std::make_unique<Config>();
+        config->fullscreen = Config::Fullscreen::Window;
+        config->width = 640;
+        config->height = 360;
+        config->hiddenWindow = true;
+        config->cpuProfiler = false;
+
+        instance = std::make_unique<Raygun>("Raygun Microbench", std::move(config));
+    }
+
+    return *instance;
+}
+
+void shutdownEngine()
+{
+    instance.reset();
+}
+
+} // namespace microbench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "raygun/raygun.hpp"
+
+namespace microbench {
+
+/// Creates the engine (hidden window) on first use, so only benchmarks
+/// depending on it pay for startup.
+raygun::Raygun& engine();
+
+void shutdownEngine();
+
+} // namespace microbench
@@ -0,0 +1,105 @@
+#include "harness.hpp"
+
+#include "raygun/entity.hpp"
+
+using namespace raygun;
+
+namespace {
+
+    std::shared_ptr<Entity> wideTree(int64_t children)
+    {
+        auto root = std::make_shared<Entity>("root");
+        for(int64_t i = 0; i < children; ++i) {
+            root->emplaceChild("child")->moveTo({(float)i, 0.0f, 0.0f});
+        }
+        return root;
+    }
+
+    /// Returns root and leaf of a chain.
+    std::pair<std::shared_ptr<Entity>, std::shared_ptr<Entity>> deepTree(int64_t depth)
+    {
+        auto root = std::make_shared<Entity>("root");
+
+        auto leaf = root;
+        for(int64_t i = 0; i < depth; ++i) {
+            leaf = leaf->emplaceChild("child");
+            leaf->moveTo({1.0f, 0.0f, 0.0f});
+            leaf->rotate(0.1f, UP);
+        }
+
+        return {root, leaf};
+    }
+
+} // namespace
+
+MICROBENCH_ARGS(Entity, forEachEntity, 1000, 100000)
+{
+    auto root = wideTree(state.arg());
+    state.setItemsPerIteration((uint64_t)state.arg() + 1);
+
+    while(state.keepRunning()) {
+        uint64_t count = 0;
+        root->forEachEntity([&](Entity&) { count++; });
+        microbench::doNotOptimize(count);
+    }
+}
+
+/// Moving the root invalidates the cached parent transforms of the whole chain.
+MICROBENCH_ARGS(Entity, globalTransformDeep, 8, 64, 512)
+{
+    auto [root, leaf] = deepTree(state.arg());
+
+    while(state.keepRunning()) {
+        root->move({0.001f, 0.0f, 0.0f});
+        auto transform = leaf->globalTransform();
+        microbench::doNotOptimize(transform);
+    }
+}
+
+MICROBENCH_ARGS(Entity, globalTransformDeepCached, 8, 64, 512)
+{
+    auto [root, leaf] = deepTree(state.arg());
+
+    while(state.keepRunning()) {
+        auto transform = leaf->globalTransform();
+        microbench::doNotOptimize(transform);
+    }
+}
+
+MICROBENCH_ARGS(Entity, globalTransformWide, 1000, 100000)
+{
+    auto root = wideTree(state.arg());
+    state.setItemsPerIteration((uint64_t)state.arg());
+
+    while(state.keepRunning()) {
+        root->move({0.001f, 0.0f, 0.0f});
+        for(const auto& child: root->children()) {
+            auto transform = child->globalTransform();
+            microbench::doNotOptimize(transform);
+        }
+    }
+}
+
+/// Adds and removes a child from a parent with many children.
+MICROBENCH_ARGS(Entity, addRemoveChild, 100, 10000)
+{
+    auto root = wideTree(state.arg());
+    auto child = std::make_shared<Entity>("extra");
+
+    while(state.keepRunning()) {
+        root->addChild(child);
+        root->removeChild(child);
+    }
+}
+
+/// Removes the first of many children, which shifts all others.
+MICROBENCH_ARGS(Entity, removeFirstChild, 100, 10000)
+{
+    auto root = wideTree(state.arg());
+
+    while(state.keepRunning()) {
+        auto first = root->children().front();
+        root->removeChild(first);
+        root->addChild(first);
+    }
+}
@@ -0,0 +1,132 @@
+#include "harness.hpp"
+
+#include "raygun/info.hpp"
+
+using namespace raygun;
+
+namespace microbench {
+
+namespace {
+
+    struct Benchmark {
+        string name;
+        BenchmarkFunction function;
+        int64_t arg;
+    };
+
+    std::vector<Benchmark>& registry()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    double nanoseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::nano>(duration).count();
+    }
+
+    /// Grows the iteration count until a run takes at least the minimum time.
+    uint64_t findIterations(const Benchmark& benchmark, double minSeconds)
+    {
+        uint64_t iterations = 1;
+
+        while(true) {
+            State state(iterations, benchmark.arg);
+            benchmark.function(state);
+
+            const auto seconds = nanoseconds(state.elapsed()) / 1e9;
+            if(seconds >= minSeconds || iterations >= 1'000'000'000) {
+                return iterations;
+            }
+
+            // Overshoot a little to avoid another round.
+            const auto estimate = seconds > 0.0 ? (double)iterations * minSeconds * 1.4 / seconds : (double)iterations * 10.0;
+            iterations = (uint64_t)std::clamp(estimate, (double)iterations + 1.0, (double)iterations * 10.0);
+        }
+    }
+
+} // namespace
+
+namespace detail {
+    void useCharPointer(const volatile char*) {}
+} // namespace detail
+
+Registration::Registration(const char* group, const char* name, BenchmarkFunction function, std::initializer_list<int64_t> args)
+{
+    for(const auto arg: args) {
+        auto fullName = fmt::format("{}/{}", group, name);
+        if(args.size() > 1) {
+            fullName += fmt::format("/{}", arg);
+        }
+
+        registry().push_back({std::move(fullName), function, arg});
+    }
+}
+
+json runBenchmarks(const Options& options)
+{
+    auto results = json::array();
+
+    for(const auto& benchmark: registry()) {
+        if(benchmark.name.find(options.filter) == string::npos) continue;
+
+        const auto iterations = findIterations(benchmark, options.minSeconds);
+
+        std::vector<double> timesNs;
+        uint64_t itemsPerIteration = 0;
+
+        for(uint32_t i = 0; i < std::max(options.repetitions, 1u); ++i) {
+            State state(iterations, benchmark.arg);
+            benchmark.function(state);
+
+            timesNs.push_back(nanoseconds(state.elapsed()) / (double)iterations);
+            itemsPerIteration = state.itemsPerIteration();
+        }
+
+        std::sort(timesNs.begin(), timesNs.end());
+        const auto median = timesNs[timesNs.size() / 2];
+
+        json result = {
+            {"name", benchmark.name},
+            {"run_type", "aggregate"},
+            {"aggregate_name", "median"},
+            {"iterations", iterations},
+            {"repetitions", timesNs.size()},
+            {"real_time", median},
+            {"cpu_time", median},
+            {"min_time", timesNs.front()},
+            {"max_time", timesNs.back()},
+            {"time_unit", "ns"},
+        };
+
+        if(itemsPerIteration > 0) {
+            result["items_per_second"] = (double)itemsPerIteration * 1e9 / median;
+        }
+
+        fmt::print("{:<48} {:>14.1f} ns {:>12} iterations\n", benchmark.name, median, iterations);
+
+        results.push_back(std::move(result));
+    }
+
+    const auto now = std::time(nullptr);
+    std::array<char, 32> date;
+    std::strftime(date.data(), date.size(), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    return {
+        {"context",
+         {
+             {"date", date.data()},
+             {"executable", "raygun_microbench"},
+             {"raygun_version", RAYGUN_VERSION},
+             {"num_cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+             {"library_build_type", "release"},
+#else
+             {"library_build_type", "debug"},
+#endif
+         }},
+        {"benchmarks", std::move(results)},
+    };
+}
+
+} // namespace microbench
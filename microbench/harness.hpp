@@ -0,0 +1,109 @@
+#pragma once
+
+#include "raygun/utils/macros.hpp"
+
+/// Registers a benchmark function, similar to Google Benchmark's BENCHMARK.
+#define MICROBENCH(_group, _name) MICROBENCH_ARGS(_group, _name, 0)
+
+/// Registers a benchmark function run once per given argument, available
+/// via State::arg.
+#define MICROBENCH_ARGS(_group, _name, ...) \
+    static void _group##_##_name(::microbench::State& state); \
+    static const ::microbench::Registration RAYGUN_CONCAT(_microbenchRegistration, __COUNTER__)(#_group, #_name, &_group##_##_name, {__VA_ARGS__}); \
+    static void _group##_##_name(::microbench::State& state)
+
+namespace microbench {
+
+/// Passed to benchmark functions, the measured code runs in a
+/// `while(state.keepRunning())` loop.
+class State {
+  public:
+    State(uint64_t iterations, int64_t arg) : m_iterations(iterations), m_arg(arg) {}
+
+    bool keepRunning()
+    {
+        if(m_iteration == 0) {
+            m_start = raygun::Clock::now();
+        }
+
+        if(m_iteration++ < m_iterations) {
+            return true;
+        }
+
+        m_elapsed += raygun::Clock::now() - m_start;
+        return false;
+    }
+
+    /// Excludes setup work within the loop from the measurement.
+    void pauseTiming() { m_elapsed += raygun::Clock::now() - m_start; }
+    void resumeTiming() { m_start = raygun::Clock::now(); }
+
+    int64_t arg() const { return m_arg; }
+    uint64_t iterations() const { return m_iterations; }
+
+    /// Items handled per iteration, reported as throughput.
+    void setItemsPerIteration(uint64_t items) { m_itemsPerIteration = items; }
+    uint64_t itemsPerIteration() const { return m_itemsPerIteration; }
+
+    raygun::Clock::duration elapsed() const { return m_elapsed; }
+
+  private:
+    uint64_t m_iterations;
+    uint64_t m_iteration = 0;
+    int64_t m_arg;
+
+    uint64_t m_itemsPerIteration = 0;
+
+    raygun::Clock::time_point m_start;
+    raygun::Clock::duration m_elapsed = raygun::Clock::duration::zero();
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+struct Registration {
+    Registration(const char* group, const char* name, BenchmarkFunction function, std::initializer_list<int64_t> args);
+};
+
+struct Options {
+    raygun::string filter;
+    double minSeconds = 0.2;
+    uint32_t repetitions = 5;
+};
+
+/// Runs all registered benchmarks matching the filter, returns results in
+/// Google Benchmark's JSON format.
+raygun::json runBenchmarks(const Options& options);
+
+namespace detail {
+    void useCharPointer(const volatile char*);
+}
+
+/// Prevents the compiler from optimizing away the computation of value.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#ifdef _MSC_VER
+    detail::useCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Additionally makes the compiler assume value was modified, so that
+/// computations on loop-invariant inputs cannot be hoisted out of the loop.
+template<typename T>
+inline void doNotOptimize(T& value)
+{
+#ifdef _MSC_VER
+    detail::useCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#elif defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    // GCC picks the first alternative and rejects "r" for some types.
+    asm volatile("" : "+m,r"(value) : : "memory");
+#endif
+}
+
+} // namespace microbench
@@ -0,0 +1,40 @@
+#include "engine.hpp"
+#include "harness.hpp"
+
+using namespace raygun;
+
+int main(int argc, char* argv[])
+{
+    microbench::Options options;
+    fs::path jsonPath = "microbench_results.json";
+
+    for(int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if(arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if(arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        }
+        else if(arg == "--min-time" && hasValue) {
+            options.minSeconds = std::stod(argv[++i]);
+        }
+        else if(arg == "--repetitions" && hasValue) {
+            options.repetitions = (uint32_t)std::stoul(argv[++i]);
+        }
+        else {
+            fmt::print("Usage: raygun_microbench [--filter <substring>] [--json <file>] [--min-time <seconds>] [--repetitions <n>]\n");
+            return 2;
+        }
+    }
+
+    const auto results = microbench::runBenchmarks(options);
+
+    microbench::shutdownEngine();
+
+    std::ofstream out(jsonPath);
+    out << results.dump(2);
+    fmt::print("Results written to {}\n", jsonPath.string());
+}
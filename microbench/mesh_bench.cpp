@@ -0,0 +1,86 @@
+#include "harness.hpp"
+
+#include "raygun/render/mesh.hpp"
+
+using namespace raygun;
+using namespace raygun::render;
+
+namespace {
+
+    /// Grid of side x side quads.
+    Mesh gridMesh(int64_t side)
+    {
+        Mesh mesh;
+
+        for(int64_t z = 0; z <= side; ++z) {
+            for(int64_t x = 0; x <= side; ++x) {
+                Vertex vertex = {};
+                vertex.position = {(float)x, std::sin((float)(x + z)), (float)z};
+                vertex.normal = UP;
+                mesh.vertices.push_back(vertex);
+            }
+        }
+
+        const auto row = (uint32_t)side + 1;
+        for(uint32_t z = 0; z < (uint32_t)side; ++z) {
+            for(uint32_t x = 0; x < (uint32_t)side; ++x) {
+                const auto i = z * row + x;
+                mesh.indices.insert(mesh.indices.end(), {i, i + row, i + 1, i + 1, i + row, i + row + 1});
+            }
+        }
+
+        return mesh;
+    }
+
+} // namespace
+
+MICROBENCH_ARGS(Mesh, bounds, 16, 256)
+{
+    auto mesh = gridMesh(state.arg());
+    state.setItemsPerIteration(mesh.vertices.size());
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(mesh);
+        auto bounds = mesh.bounds();
+        microbench::doNotOptimize(bounds);
+    }
+}
+
+MICROBENCH_ARGS(Mesh, center, 16, 256)
+{
+    auto mesh = gridMesh(state.arg());
+    state.setItemsPerIteration(mesh.vertices.size());
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(mesh);
+        auto center = mesh.center();
+        microbench::doNotOptimize(center);
+    }
+}
+
+/// Includes copying the destination mesh.
+MICROBENCH_ARGS(Mesh, merge, 16, 256)
+{
+    const auto base = gridMesh(state.arg());
+    const auto other = gridMesh(state.arg());
+
+    while(state.keepRunning()) {
+        auto mesh = base;
+        mesh.merge(other);
+        microbench::doNotOptimize(mesh.indices.data());
+    }
+}
+
+MICROBENCH_ARGS(Mesh, forEachFace, 16, 256)
+{
+    const auto mesh = gridMesh(state.arg());
+    state.setItemsPerIteration(mesh.numFaces());
+
+    while(state.keepRunning()) {
+        float area = 0.0f;
+        mesh.forEachFace([&](const Vertex& a, const Vertex& b, const Vertex& c) {
+            area += glm::length(glm::cross(b.position - a.position, c.position - a.position));
+        });
+        microbench::doNotOptimize(area);
+    }
+}
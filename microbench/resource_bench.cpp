@@ -0,0 +1,78 @@
+#include "harness.hpp"
+
+#include "engine.hpp"
+#include "raygun/ui/ui.hpp"
+
+using namespace raygun;
+
+MICROBENCH(ResourceManager, loadMaterialCached)
+{
+    auto& resourceManager = microbench::engine().resourceManager();
+    resourceManager.loadMaterial("floor");
+
+    while(state.keepRunning()) {
+        auto material = resourceManager.loadMaterial("floor");
+        microbench::doNotOptimize(material);
+    }
+}
+
+MICROBENCH(ResourceManager, loadFontCached)
+{
+    auto& resourceManager = microbench::engine().resourceManager();
+    resourceManager.loadFont("NotoSans");
+
+    while(state.keepRunning()) {
+        auto font = resourceManager.loadFont("NotoSans");
+        microbench::doNotOptimize(font);
+    }
+}
+
+MICROBENCH(ResourceManager, entityLoadPath)
+{
+    auto& resourceManager = microbench::engine().resourceManager();
+
+    while(state.keepRunning()) {
+        auto path = resourceManager.entityLoadPath("room");
+        microbench::doNotOptimize(path);
+    }
+}
+
+MICROBENCH_ARGS(TextGenerator, text, 16, 256)
+{
+    const ui::Factory factory(microbench::engine().resourceManager().loadFont("NotoSans"));
+
+    string input;
+    for(int64_t i = 0; i < state.arg(); ++i) {
+        input += (char)('a' + i % 26);
+        if(i % 12 == 11) input += ' ';
+    }
+    state.setItemsPerIteration((uint64_t)state.arg());
+
+    while(state.keepRunning()) {
+        auto text = factory.textGen().text(input);
+        microbench::doNotOptimize(text);
+    }
+}
+
+/// JSON parsing alone.
+MICROBENCH(Material, parseJson)
+{
+    std::ifstream in("resources/materials/glass.rgmat.json");
+    const string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+    while(state.keepRunning()) {
+        auto data = json::parse(content);
+        microbench::doNotOptimize(data);
+    }
+}
+
+/// Parsing and applying parameters, including the physics material.
+MICROBENCH(Material, load)
+{
+    microbench::engine();
+
+    while(state.keepRunning()) {
+        Material material("glass", "resources/materials/glass.rgmat.json");
+        microbench::doNotOptimize(material);
+    }
+}
@@ -0,0 +1,126 @@
+#include "harness.hpp"
+
+#include "raygun/transform.hpp"
+#include "raygun/transform_batch.hpp"
+
+using namespace raygun;
+
+namespace {
+
+    Transform sampleTransform(float seed)
+    {
+        Transform transform;
+        transform.position = {seed, 2.0f * seed, -seed};
+        transform.rotation = glm::angleAxis(seed, glm::normalize(vec3{1.0f, seed, 0.5f}));
+        transform.scaling = vec3{1.0f + 0.1f * seed};
+        return transform;
+    }
+
+    std::vector<Transform> sampleTransforms(int64_t count, float offset)
+    {
+        std::vector<Transform> transforms;
+        for(int64_t i = 0; i < count; ++i) {
+            transforms.push_back(sampleTransform(offset + 0.001f * (float)i));
+        }
+        return transforms;
+    }
+
+    /// Same layout as VkAccelerationStructureInstanceKHR.
+    struct Instance {
+        float matrix[3][4];
+        uint32_t data[4];
+    };
+
+} // namespace
+
+MICROBENCH(Transform, multiply)
+{
+    auto x = sampleTransform(0.3f);
+    auto y = sampleTransform(0.7f);
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(y);
+        x = x * y;
+        microbench::doNotOptimize(x);
+    }
+}
+
+MICROBENCH(Transform, toMat4)
+{
+    auto transform = sampleTransform(0.3f);
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(transform);
+        auto mat = transform.toMat4();
+        microbench::doNotOptimize(mat);
+    }
+}
+
+MICROBENCH(Transform, interpolate)
+{
+    auto x = sampleTransform(0.3f);
+    auto y = sampleTransform(0.7f);
+    float factor = 0.0f;
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(x);
+        microbench::doNotOptimize(y);
+        auto result = interpolate(x, y, factor);
+        microbench::doNotOptimize(result);
+        factor = factor >= 1.0f ? 0.0f : factor + 0.01f;
+    }
+}
+
+MICROBENCH(Transform, fromMat4)
+{
+    auto mat = sampleTransform(0.3f).toMat4();
+
+    while(state.keepRunning()) {
+        microbench::doNotOptimize(mat);
+        Transform transform(mat);
+        microbench::doNotOptimize(transform);
+    }
+}
+
+/// Reference for composeMatrices, as previously done during TLAS build.
+MICROBENCH_ARGS(Transform, composeMatricesScalar, 64, 4096)
+{
+    const auto parents = sampleTransforms(state.arg(), 0.3f);
+    const auto locals = sampleTransforms(state.arg(), 0.7f);
+    std::vector<Instance> instances((size_t)state.arg());
+    state.setItemsPerIteration((uint64_t)state.arg());
+
+    while(state.keepRunning()) {
+        for(size_t i = 0; i < instances.size(); ++i) {
+            const auto mat = glm::transpose((parents[i] * locals[i]).toMat4());
+            memcpy(instances[i].matrix, &mat, sizeof(instances[i].matrix));
+        }
+        microbench::doNotOptimize(instances);
+    }
+}
+
+MICROBENCH_ARGS(Transform, composeMatrices, 64, 4096)
+{
+    const auto parents = sampleTransforms(state.arg(), 0.3f);
+    const auto locals = sampleTransforms(state.arg(), 0.7f);
+    std::vector<Instance> instances((size_t)state.arg());
+    state.setItemsPerIteration((uint64_t)state.arg());
+
+    while(state.keepRunning()) {
+        composeMatrices(parents.data(), locals.data(), &instances[0].matrix[0][0], sizeof(Instance), instances.size());
+        microbench::doNotOptimize(instances);
+    }
+}
+
+MICROBENCH_ARGS(Transform, composeTransforms, 64, 4096)
+{
+    const auto parents = sampleTransforms(state.arg(), 0.3f);
+    const auto locals = sampleTransforms(state.arg(), 0.7f);
+    std::vector<Transform> results((size_t)state.arg());
+    state.setItemsPerIteration((uint64_t)state.arg());
+
+    while(state.keepRunning()) {
+        composeTransforms(parents.data(), locals.data(), results.data(), results.size());
+        microbench::doNotOptimize(results);
+    }
+}
@@ -63,6 +63,8 @@ void AudioSystem::setupDefaultSources()
 
 void AudioSystem::update()
 {
+    RAYGUN_PROFILE_ZONE("Audio");
+
     const auto& scene = RG().scene();
 
     moveListener(scene.camera->transform());
@@ -31,7 +31,7 @@ class Camera : public Entity {
   public:
     Camera();
 
-    mat4 viewInverse() const { return transform().toMat4(); }
+    mat4 viewInverse(float interpolation = 1.0f) const { return interpolatedTransform(interpolation).toMat4(); }
 
     mat4 projInverse() const { return glm::inverse(m_projection); }
 
@@ -39,18 +39,74 @@ void ComputePass::dispatch(vk::CommandBuffer& cmd, uint32_t width, uint32_t heig
     cmd.dispatch(width, height, depth);
 }
 
-ComputePass::ComputePass(string_view name) : computeShader(RG().resourceManager().loadShader(name)), cs(RG().computeSystem())
+ComputePass::ComputePass(string_view name) : name(name), cs(RG().computeSystem())
 {
-    auto shaderStageInfo = computeShader->shaderStageInfo(vk::ShaderStageFlagBits::eCompute);
+    computeShader = RG().resourceManager().loadShader(name);
+    computePipeline = createPipeline(*computeShader);
+
+    cs.passes.insert(this);
+
+    RAYGUN_TRACE("Compute pass {} initialized", name);
+}
+
+ComputePass::~ComputePass()
+{
+    cs.passes.erase(this);
+}
+
+vk::UniquePipeline ComputePass::createPipeline(const gpu::Shader& shader) const
+{
+    auto shaderStageInfo = shader.shaderStageInfo(vk::ShaderStageFlagBits::eCompute);
 
     vk::ComputePipelineCreateInfo pipeInfo;
     pipeInfo.setLayout(*cs.computePipelineLayout);
     pipeInfo.setStage(shaderStageInfo);
 
-    computePipeline = cs.vc.device->createComputePipelineUnique(nullptr, pipeInfo).value;
-    RG().vc().setObjectName(*computePipeline, name);
+    const auto startTime = Clock::now();
 
-    RAYGUN_TRACE("Compute pass {} initialized", name);
+    auto pipeline = cs.vc.device->createComputePipelineUnique(cs.vc.pipelineCache->cache(), pipeInfo).value;
+    cs.vc.setObjectName(*pipeline, name);
+
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_DEBUG("Compute pipeline {} created in {:.2f} ms", name, duration.count());
+
+    return pipeline;
+}
+
+void ComputePass::rebuild()
+{
+    // Only one rebuild in flight.
+    if(pendingPipeline.valid()) {
+        pendingPipeline.wait();
+        swapPipeline();
+    }
+
+    // The shader is loaded on the calling thread, the resource manager is not
+    // thread-safe.
+    pendingShader = RG().resourceManager().loadShader(name);
+    pendingPipeline = std::async(std::launch::async, [this, shader = pendingShader] { return createPipeline(*shader); });
+}
+
+void ComputePass::swapPipeline()
+{
+    if(!pendingPipeline.valid() || pendingPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    vk::UniquePipeline pipeline;
+    try {
+        pipeline = pendingPipeline.get();
+    }
+    catch(const std::exception& e) {
+        RAYGUN_WARN("Unable to rebuild compute pipeline {}: {}", name, e.what());
+        return;
+    }
+
+    RG().renderSystem().retire(std::move(computePipeline));
+    computePipeline = std::move(pipeline);
+    computeShader = std::move(pendingShader);
+
+    RAYGUN_INFO("Compute pipeline {} swapped", name);
 }
 
 ComputeSystem::ComputeSystem() : vc(RG().vc())
@@ -121,6 +177,22 @@ UniqueComputePass ComputeSystem::createComputePass(string_view name)
     return UniqueComputePass{new ComputePass{name}};
 }
 
+void ComputeSystem::reloadShaders(const std::set<string>& changedShaders)
+{
+    for(auto pass: passes) {
+        if(changedShaders.count(pass->shaderName())) {
+            pass->rebuild();
+        }
+    }
+}
+
+void ComputeSystem::swapPipelines()
+{
+    for(auto pass: passes) {
+        pass->swapPipeline();
+    }
+}
+
 void ComputeSystem::bindDescriptorSet(vk::CommandBuffer& cmd)
 {
     cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *computePipelineLayout, 0, descriptorSet.set(), {});
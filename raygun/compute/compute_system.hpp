@@ -35,14 +35,31 @@ class ComputeSystem;
 
 class ComputePass {
   public:
+    ~ComputePass();
+
     void dispatch(vk::CommandBuffer& cmd, uint32_t width, uint32_t height = 1, uint32_t depth = 1);
 
+    const string& shaderName() const { return name; }
+
   private:
     ComputePass(string_view name);
 
+    vk::UniquePipeline createPipeline(const gpu::Shader& shader) const;
+
+    /// Starts rebuilding the pipeline in the background.
+    void rebuild();
+
+    /// Swaps in the rebuilt pipeline once it is ready.
+    void swapPipeline();
+
+    string name;
+
     std::shared_ptr<gpu::Shader> computeShader;
     vk::UniquePipeline computePipeline;
 
+    std::shared_ptr<gpu::Shader> pendingShader;
+    std::future<vk::UniquePipeline> pendingPipeline;
+
     ComputeSystem& cs;
 
     friend class ComputeSystem;
@@ -58,9 +75,17 @@ class ComputeSystem {
 
     UniqueComputePass createComputePass(string_view name);
 
+    /// Starts rebuilding the pipelines of all compute passes using one of the
+    /// given shaders in the background.
+    void reloadShaders(const std::set<string>& changedShaders);
+
+    /// Swaps in rebuilt pipelines which are ready. Must be called between
+    /// frames, old pipelines are retired.
+    void swapPipelines();
+
   private:
     static constexpr int PRE_IMG_ELEMENTS = 1;
-    static constexpr int NUM_IMAGES = 7;
+    static constexpr int NUM_IMAGES = 10;
     static constexpr int NUM_MIP_IMAGES = 0;
 
     void bindDescriptorSet(vk::CommandBuffer& cmd);
@@ -71,6 +96,8 @@ class ComputeSystem {
 
     vk::UniqueSampler linearClampedSampler;
 
+    std::set<ComputePass*> passes;
+
     VulkanContext& vc;
 
     friend class ComputePass;
@@ -24,6 +24,7 @@
 
 #include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
+#include "raygun/scene.hpp"
 #include "raygun/utils/assimp_utils.hpp"
 
 namespace raygun {
@@ -83,6 +84,18 @@ namespace {
 
 Entity::Entity(string_view name) : name(name) {}
 
+Entity::~Entity()
+{
+    // Pending changes must not refer to the actor after its release.
+    if(m_scene && m_physicsActor) {
+        m_scene->removePhysicsActor(*m_physicsActor);
+    }
+
+    if(m_physicsActor) {
+        RG().physicsSystem().forgetActor(*m_physicsActor);
+    }
+}
+
 Entity::Entity(string_view name, fs::path filepath, bool loadMaterials) : Entity(name)
 {
     Assimp::Importer importer;
@@ -179,11 +192,17 @@ void Entity::clearChildren()
 
 void Entity::setTransform(Transform transform)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform = transform;
     updatePhysicsTransform();
 }
 
+void Entity::setSimulatedTransform(Transform transform)
+{
+    invalidateChildrenCachedParentTransform();
+    m_transform = transform;
+}
+
 Transform Entity::parentTransform() const
 {
     if(!m_cachedParentTransform) {
@@ -198,73 +217,127 @@ Transform Entity::globalTransform() const
     return parentTransform() * m_transform;
 }
 
+Transform Entity::interpolatedTransform(float factor) const
+{
+    if(!m_previousTransform) return globalTransform();
+
+    return interpolate(*m_previousTransform, globalTransform(), factor);
+}
+
 void Entity::move(const vec3& translation)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.move(translation);
     updatePhysicsTransform();
 }
 
 void Entity::moveTo(const vec3& position)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.position = position;
     updatePhysicsTransform();
 }
 
 void Entity::rotate(float angle, vec3 axis)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.rotate(angle, axis);
     updatePhysicsTransform();
 }
 
 void Entity::rotate(vec3 rotation)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.rotate(rotation);
     updatePhysicsTransform();
 }
 
 void Entity::rotateAround(vec3 pivot, vec3 rotation)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.rotateAround(pivot, rotation);
     updatePhysicsTransform();
 }
 
 void Entity::lookAt(const vec3& target)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.lookAt(target);
     updatePhysicsTransform();
 }
 
 void Entity::scale(vec3 s)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.scale(s);
     updatePhysicsTransform();
 }
 
 void Entity::scale(float s)
 {
-    invalidateChildrenCachedParentTransform();
+    transformChanged();
     m_transform.scale(s);
     updatePhysicsTransform();
 }
 
+void Entity::setPhysicsActor(physics::UniqueActor actor)
+{
+    if(m_scene && m_physicsActor) {
+        m_scene->removePhysicsActor(*m_physicsActor);
+    }
+
+    if(m_physicsActor) {
+        RG().physicsSystem().forgetActor(*m_physicsActor);
+    }
+
+    m_physicsActor = std::move(actor);
+
+    if(m_physicsActor) {
+        m_physicsActor->userData = (void*)this;
+
+        if(m_scene) {
+            m_scene->addPhysicsActor(*m_physicsActor);
+        }
+    }
+}
+
 void Entity::setParent(const Entity* parent)
 {
     invalidateCachedParentTransform();
     m_parent = parent;
+    setScene(parent ? parent->m_scene : nullptr);
 }
 
-void Entity::invalidateCachedParentTransform()
+void Entity::setScene(Scene* scene)
+{
+    if(m_scene == scene) return;
+
+    if(m_scene && m_physicsActor) {
+        m_scene->removePhysicsActor(*m_physicsActor);
+    }
+
+    m_scene = scene;
+
+    if(m_scene && m_physicsActor) {
+        m_scene->addPhysicsActor(*m_physicsActor);
+    }
+
+    for(const auto& child: m_children) {
+        child->setScene(scene);
+    }
+}
+
+void Entity::invalidateCachedParentTransform(bool resetPrevious)
 {
     m_cachedParentTransform.reset();
 
-    invalidateChildrenCachedParentTransform();
+    if(resetPrevious) {
+        m_previousTransform.reset();
+    }
+
+    for(const auto& child: m_children) {
+        child->invalidateCachedParentTransform(resetPrevious);
+    }
 }
 
 void Entity::invalidateChildrenCachedParentTransform()
@@ -274,9 +347,24 @@ void Entity::invalidateChildrenCachedParentTransform()
     }
 }
 
+void Entity::transformChanged()
+{
+    // Changes made outside a simulation step (input, UI, teleports) are not
+    // interpolated, otherwise they would be blended with a stale previous
+    // transform until the next step.
+    const bool resetPrevious = !m_scene || !m_scene->inSimulationStep();
+    if(resetPrevious) {
+        m_previousTransform.reset();
+    }
+
+    for(const auto& child: m_children) {
+        child->invalidateCachedParentTransform(resetPrevious);
+    }
+}
+
 void Entity::updatePhysicsTransform()
 {
-    if(auto rigidDynamic = dynamic_cast<physx::PxRigidDynamic*>(physicsActor.get())) {
+    if(auto rigidDynamic = dynamic_cast<physx::PxRigidDynamic*>(m_physicsActor.get())) {
         rigidDynamic->setGlobalPose(physics::toTransform(globalTransform()));
     }
 }
@@ -29,6 +29,8 @@
 
 namespace raygun {
 
+struct Scene;
+
 class Entity {
   public:
     explicit Entity(string_view name);
@@ -38,17 +40,38 @@ class Entity {
     /// automatically.
     Entity(string_view name, fs::path filepath, bool loadMaterials = true);
 
-    virtual ~Entity() {}
+    virtual ~Entity();
 
     const Transform& transform() const { return m_transform; }
     void setTransform(Transform transform);
 
+    /// Same as setTransform, but does not update the physics actor. Used when
+    /// the transform originates from the physics simulation.
+    void setSimulatedTransform(Transform transform);
+
+    const Entity* parent() const { return m_parent; }
+
+    /// Scene this entity is part of (via its parents), if any.
+    Scene* scene() const { return m_scene; }
+
     /// Returns the accumulated Transform of all (direct and transitive) parents.
     Transform parentTransform() const;
 
     /// Returns the accumulated Transform of all (direct and transitive) parents and self.
     Transform globalTransform() const;
 
+    /// Global transform of the previous simulation step, if stored.
+    const std::optional<Transform>& previousTransform() const { return m_previousTransform; }
+    void storePreviousTransform() { m_previousTransform = globalTransform(); }
+
+    /// Prevents interpolation from the previous simulation step, e.g. after
+    /// teleporting.
+    void resetPreviousTransform() { m_previousTransform.reset(); }
+
+    /// Returns the global transform interpolated between the previous and the
+    /// current simulation step.
+    Transform interpolatedTransform(float factor) const;
+
     bool isVisible() const { return m_visible; }
     void setVisible(bool visible) { m_visible = visible; }
     void show() { setVisible(true); }
@@ -102,17 +125,30 @@ class Entity {
 
     std::shared_ptr<render::Model> model;
 
-    physics::UniqueActor physicsActor;
+    physx::PxActor* physicsActor() const { return m_physicsActor.get(); }
+
+    /// Replaces the physics actor. While the entity is part of a Scene, the
+    /// actor is added to its physics scene with the next physics update.
+    void setPhysicsActor(physics::UniqueActor actor);
 
     audio::UniqueSource audioSource;
 
   private:
+    friend struct Scene;
+
     void setParent(const Entity* parent);
     void clearParent() { setParent(nullptr); }
 
-    void invalidateCachedParentTransform();
+    /// Moves this entity and its children to the given scene, updating the
+    /// physics actors accordingly.
+    void setScene(Scene* scene);
+
+    void invalidateCachedParentTransform(bool resetPrevious = false);
     void invalidateChildrenCachedParentTransform();
 
+    /// Called before the local transform is changed directly.
+    void transformChanged();
+
     void updatePhysicsTransform();
 
     Transform m_transform;
@@ -127,6 +163,14 @@ class Entity {
     // changes.
     mutable std::optional<Transform> m_cachedParentTransform;
 
+    std::optional<Transform> m_previousTransform;
+
+    // Invariant: Needs to match the parent's scene, physics actors are
+    // registered with it.
+    Scene* m_scene = nullptr;
+
+    physics::UniqueActor m_physicsActor;
+
     std::vector<std::shared_ptr<Entity>> m_children;
 };
 
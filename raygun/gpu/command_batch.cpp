@@ -0,0 +1,133 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/gpu/command_batch.hpp"
+
+#include "raygun/raygun.hpp"
+
+namespace raygun::gpu {
+
+bool CompletionToken::ready() const
+{
+    return !m_queue || m_queue->completedValue() >= m_value;
+}
+
+void CompletionToken::wait() const
+{
+    if(m_queue) {
+        m_queue->wait(m_value);
+    }
+}
+
+CommandBatch::CommandBatch(Queue& queue, string_view name) : m_queue(queue)
+{
+    auto& vc = RG().vc();
+
+    vk::CommandPoolCreateInfo poolInfo = {};
+    poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+    poolInfo.setQueueFamilyIndex(queue.familyIndex());
+    m_commandPool = vc.device->createCommandPoolUnique(poolInfo);
+    vc.setObjectName(*m_commandPool, name);
+
+    vk::CommandBufferAllocateInfo bufferInfo = {};
+    bufferInfo.setCommandPool(*m_commandPool);
+    bufferInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+    bufferInfo.setCommandBufferCount(1);
+    m_commandBuffer = std::move(vc.device->allocateCommandBuffersUnique(bufferInfo).at(0));
+    vc.setObjectName(*m_commandBuffer, name);
+
+    m_commandBuffer->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+}
+
+CommandBatch::~CommandBatch()
+{
+    if(!m_submitted) {
+        submit();
+    }
+}
+
+vk::CommandBuffer& CommandBatch::commandBuffer()
+{
+    RAYGUN_ASSERT(!m_submitted);
+
+    flushTransitions();
+
+    return *m_commandBuffer;
+}
+
+void CommandBatch::imageLayoutTransition(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, const vk::ImageSubresourceRange& range)
+{
+    RAYGUN_ASSERT(!m_submitted);
+
+    auto& barrier = m_pendingTransitions.emplace_back();
+    barrier.setImage(image);
+    barrier.setOldLayout(oldLayout);
+    barrier.setNewLayout(newLayout);
+    barrier.setSubresourceRange(range);
+}
+
+void CommandBatch::copyBuffer(const Buffer& src, const Buffer& dst, vk::DeviceSize size, vk::DeviceSize srcOffset, vk::DeviceSize dstOffset)
+{
+    vk::BufferCopy region = {};
+    region.setSrcOffset(srcOffset);
+    region.setDstOffset(dstOffset);
+    region.setSize(size);
+
+    commandBuffer().copyBuffer(src, dst, region);
+}
+
+CompletionToken CommandBatch::submit()
+{
+    RAYGUN_ASSERT(!m_submitted);
+
+    flushTransitions();
+
+    m_commandBuffer->end();
+
+    const auto value = m_queue.submit(*m_commandBuffer);
+    m_submitted = true;
+
+    // Command buffer and attached resources are released once the GPU is
+    // done with them, no need to block here.
+    struct Retired {
+        vk::UniqueCommandPool commandPool;
+        vk::UniqueCommandBuffer commandBuffer;
+        std::vector<std::shared_ptr<void>> resources;
+    };
+
+    m_queue.retire(value, Retired{std::move(m_commandPool), std::move(m_commandBuffer), std::move(m_resources)});
+
+    return {m_queue, value};
+}
+
+void CommandBatch::flushTransitions()
+{
+    if(m_pendingTransitions.empty()) return;
+
+    m_commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, vk::DependencyFlagBits::eByRegion,
+                                     {}, {}, m_pendingTransitions);
+
+    m_pendingTransitions.clear();
+}
+
+} // namespace raygun::gpu
@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/gpu/gpu_buffer.hpp"
+#include "raygun/gpu/gpu_queue.hpp"
+
+namespace raygun::gpu {
+
+/// Completion of a GPU submission, a value on a queue's timeline. Tokens can
+/// be copied and waited on from any thread.
+class CompletionToken {
+  public:
+    /// A default constructed token is always complete.
+    CompletionToken() = default;
+
+    CompletionToken(Queue& queue, uint64_t value) : m_queue(&queue), m_value(value) {}
+
+    bool ready() const;
+
+    /// Blocks until the submission has been executed.
+    void wait() const;
+
+    Queue* queue() const { return m_queue; }
+
+    uint64_t value() const { return m_value; }
+
+  private:
+    Queue* m_queue = nullptr;
+    uint64_t m_value = 0;
+};
+
+/// Collects one-time work of many objects (layout transitions, buffer copies,
+/// acceleration structure builds, ...) into a single command buffer which is
+/// submitted once.
+///
+/// A batch uses its own command pool, it can be recorded on any thread.
+class CommandBatch {
+  public:
+    CommandBatch(Queue& queue, string_view name);
+
+    /// Submits the batch if this has not been done yet.
+    ~CommandBatch();
+
+    CommandBatch(const CommandBatch&) = delete;
+    CommandBatch& operator=(const CommandBatch&) = delete;
+
+    /// Command buffer for recording arbitrary commands. Pending layout
+    /// transitions are recorded first.
+    vk::CommandBuffer& commandBuffer();
+
+    /// Layout transitions are combined into a single pipeline barrier.
+    void imageLayoutTransition(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, const vk::ImageSubresourceRange& range);
+
+    void copyBuffer(const Buffer& src, const Buffer& dst, vk::DeviceSize size, vk::DeviceSize srcOffset = 0, vk::DeviceSize dstOffset = 0);
+
+    /// Keeps the given resource (e.g. a staging buffer) alive until the batch
+    /// has been executed. Released by Queue::runCompletedCallbacks.
+    template<typename T>
+    void keepAlive(T resource)
+    {
+        m_resources.push_back(std::make_shared<T>(std::move(resource)));
+    }
+
+    CompletionToken submit();
+
+  private:
+    Queue& m_queue;
+
+    vk::UniqueCommandPool m_commandPool;
+    vk::UniqueCommandBuffer m_commandBuffer;
+
+    std::vector<vk::ImageMemoryBarrier> m_pendingTransitions;
+
+    std::vector<std::shared_ptr<void>> m_resources;
+
+    bool m_submitted = false;
+
+    void flushTransitions();
+};
+
+} // namespace raygun::gpu
@@ -23,10 +23,50 @@
 #include "raygun/gpu/descriptor_set.hpp"
 
 #include "raygun/assert.hpp"
+#include "raygun/profiler.hpp"
 #include "raygun/raygun.hpp"
 
 namespace raygun::gpu {
 
+namespace {
+
+    template<typename T>
+    uint64_t handleValue(T handle)
+    {
+        return reinterpret_cast<uint64_t>(static_cast<typename T::CType>(handle));
+    }
+
+    /// Flattens everything a write refers to, for comparison with previous
+    /// writes.
+    void writeContent(const vk::WriteDescriptorSet& write, utils::ArenaVector<uint64_t>& content)
+    {
+        content.clear();
+        content.insert(content.end(), {(uint64_t)write.descriptorType, write.descriptorCount});
+
+        if(write.pBufferInfo) {
+            for(uint32_t i = 0; i < write.descriptorCount; ++i) {
+                const auto& info = write.pBufferInfo[i];
+                content.insert(content.end(), {handleValue(info.buffer), info.offset, info.range});
+            }
+        }
+
+        if(write.pImageInfo) {
+            for(uint32_t i = 0; i < write.descriptorCount; ++i) {
+                const auto& info = write.pImageInfo[i];
+                content.insert(content.end(), {handleValue(info.sampler), handleValue(info.imageView), (uint64_t)info.imageLayout});
+            }
+        }
+
+        if(write.descriptorType == vk::DescriptorType::eAccelerationStructureKHR) {
+            const auto& info = *static_cast<const vk::WriteDescriptorSetAccelerationStructureKHR*>(write.pNext);
+            for(uint32_t i = 0; i < info.accelerationStructureCount; ++i) {
+                content.push_back(handleValue(info.pAccelerationStructures[i]));
+            }
+        }
+    }
+
+} // namespace
+
 DescriptorSet::DescriptorSet() : vc(RG().vc()) {}
 
 void DescriptorSet::addBinding(uint32_t binding, uint32_t count, vk::DescriptorType type, vk::ShaderStageFlags stage)
@@ -91,7 +131,32 @@ void DescriptorSet::bind(vk::WriteDescriptorSet write)
 
 void DescriptorSet::update()
 {
-    vc.device->updateDescriptorSets(m_pendingWrites, {});
+    RAYGUN_PROFILE_ZONE("Descriptor Update");
+
+    utils::ArenaVector<uint64_t> content(RG().frameArena());
+
+    // Pending writes are filtered in place. Stored content is overwritten
+    // in place as well, keeping unchanged descriptors free of allocations.
+    auto end = std::remove_if(m_pendingWrites.begin(), m_pendingWrites.end(), [&](const vk::WriteDescriptorSet& write) {
+        const auto key = (uint64_t)write.dstBinding << 32 | write.dstArrayElement;
+
+        writeContent(write, content);
+
+        auto& written = m_writtenContent[key];
+        if(std::equal(written.begin(), written.end(), content.begin(), content.end())) {
+            return true;
+        }
+
+        written.assign(content.begin(), content.end());
+        return false;
+    });
+    m_pendingWrites.erase(end, m_pendingWrites.end());
+
+    if(!m_pendingWrites.empty()) {
+        vc.device->updateDescriptorSets(m_pendingWrites, {});
+    }
+
+    RG().profiler().count(CounterID::DescriptorWrites, (uint32_t)m_pendingWrites.size());
 
     m_pendingWrites.clear();
 }
@@ -50,7 +50,12 @@ class DescriptorSet {
     void bind(uint32_t binding, const render::TopLevelAS& accelerationStructure);
     void bind(vk::WriteDescriptorSet write);
 
-    /// Executes all pending binding requests.
+    /// Executes all pending binding requests. Requests which match what has
+    /// last been written to a binding are skipped.
+    ///
+    /// Resources are identified by their handles. This relies on replaced
+    /// resources being retired (see RenderSystem::retire) rather than
+    /// destroyed while still bound, so that handles are not reused.
     void update();
 
     vk::WriteDescriptorSet writeFromBinding(uint32_t binding);
@@ -78,6 +83,9 @@ class DescriptorSet {
     vk::DescriptorSet generateSet() const;
 
     std::vector<vk::WriteDescriptorSet> m_pendingWrites;
+
+    /// Content last written to each binding (and array element).
+    std::unordered_map<uint64_t, std::vector<uint64_t>> m_writtenContent;
 };
 
 } // namespace raygun::gpu
@@ -20,15 +20,59 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+
 #include "raygun/gpu/gpu_queue.hpp"
 
+#include "raygun/assert.hpp"
+#include "raygun/logging.hpp"
+
 namespace raygun::gpu {
 
-Queue::Queue(const vk::Device& device, uint32_t familyIndex) : m_familyIndex(familyIndex), m_device(device)
+namespace {
+
+    // Waits are split into slices of this length so that stalls get reported.
+    constexpr auto WAIT_SLICE = std::chrono::seconds(1);
+
+    // The GPU is considered hung after this many slices.
+    constexpr int MAX_WAIT_SLICES = 10;
+
+    // Including the queue's timeline.
+    constexpr uint32_t MAX_SIGNAL_SEMAPHORES = 8;
+
+    /// Moves entries the GPU is done with from pending to completed, keeping
+    /// the order of the remaining ones.
+    template<typename T>
+    void takeCompleted(std::vector<std::pair<uint64_t, T>>& pending, uint64_t completedValue, std::vector<T>& completed)
+    {
+        size_t kept = 0;
+        for(size_t i = 0; i < pending.size(); ++i) {
+            if(pending[i].first <= completedValue) {
+                completed.push_back(std::move(pending[i].second));
+            }
+            else {
+                if(i != kept) {
+                    pending[kept] = std::move(pending[i]);
+                }
+                kept++;
+            }
+        }
+        pending.erase(pending.begin() + kept, pending.end());
+    }
+
+} // namespace
+
+Queue::Queue(const vk::Device& device, uint32_t familyIndex, std::shared_ptr<std::mutex> submitMutex)
+    : m_familyIndex(familyIndex)
+    , m_submitMutex(std::move(submitMutex))
+    , m_device(device)
 {
+    RAYGUN_ASSERT(m_submitMutex);
+
     m_queue = device.getQueue(m_familyIndex, 0);
 
     setupCommandPool();
+
+    setupTimeline();
 }
 
 vk::UniqueCommandBuffer Queue::createCommandBuffer()
@@ -41,23 +85,123 @@ vk::UniqueCommandBuffer Queue::createCommandBuffer()
     return std::move(m_device.allocateCommandBuffersUnique(info).at(0));
 }
 
-void Queue::submit(vk::ArrayProxy<const vk::CommandBuffer> cmds, vk::Fence fence, vk::ArrayProxy<const vk::Semaphore> signalSemaphores,
-                   vk::ArrayProxy<const vk::Semaphore> waitSemaphores)
+uint64_t Queue::submit(vk::ArrayProxy<const vk::CommandBuffer> cmds, vk::ArrayProxy<const vk::Semaphore> waitSemaphores,
+                       vk::ArrayProxy<const vk::PipelineStageFlags> waitStages, vk::ArrayProxy<const vk::Semaphore> signalSemaphores)
 {
+    RAYGUN_ASSERT(waitSemaphores.size() == waitStages.size());
+
+    std::lock_guard lock(*m_submitMutex);
+
+    const auto value = m_submittedValue + 1;
+
+    // The timeline is signaled alongside the given (binary) semaphores, their
+    // values are ignored. Fixed-size storage keeps submissions free of heap
+    // allocations.
+    RAYGUN_ASSERT(signalSemaphores.size() < MAX_SIGNAL_SEMAPHORES);
+    const auto semaphoreCount = signalSemaphores.size() + 1;
+
+    std::array<vk::Semaphore, MAX_SIGNAL_SEMAPHORES> semaphores;
+    std::copy(signalSemaphores.begin(), signalSemaphores.end(), semaphores.begin());
+    semaphores[semaphoreCount - 1] = *m_timeline;
+
+    std::array<uint64_t, MAX_SIGNAL_SEMAPHORES> values = {};
+    values[semaphoreCount - 1] = value;
+
+    vk::TimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.setSignalSemaphoreValueCount(semaphoreCount);
+    timelineInfo.setPSignalSemaphoreValues(values.data());
+
     vk::SubmitInfo info = {};
     info.setCommandBufferCount(cmds.size());
     info.setPCommandBuffers(cmds.data());
-    info.setSignalSemaphoreCount(signalSemaphores.size());
-    info.setPSignalSemaphores(signalSemaphores.data());
     info.setWaitSemaphoreCount(waitSemaphores.size());
     info.setPWaitSemaphores(waitSemaphores.data());
+    info.setPWaitDstStageMask(waitStages.data());
+    info.setSignalSemaphoreCount(semaphoreCount);
+    info.setPSignalSemaphores(semaphores.data());
+    info.setPNext(&timelineInfo);
+
+    m_queue.submit(info, nullptr);
+
+    m_submittedValue = value;
+
+    return value;
+}
 
-    submit(info, fence);
+vk::Result Queue::present(const vk::PresentInfoKHR& info)
+{
+    std::lock_guard lock(*m_submitMutex);
+
+    return m_queue.presentKHR(info);
 }
 
-void Queue::submit(vk::ArrayProxy<const vk::SubmitInfo> infos, vk::Fence fence)
+uint64_t Queue::completedValue() const
 {
-    m_queue.submit(infos, fence);
+    return m_device.getSemaphoreCounterValue(*m_timeline);
+}
+
+void Queue::wait(uint64_t value)
+{
+    RAYGUN_ASSERT(value <= m_submittedValue);
+
+    for(int slice = 1; !waitFor(value, WAIT_SLICE); ++slice) {
+        if(slice == MAX_WAIT_SLICES) {
+            RAYGUN_FATAL("GPU did not reach timeline value {} (completed {})", value, completedValue());
+        }
+
+        RAYGUN_WARN("Waiting for GPU timeline value {} since {} s", value, slice);
+    }
+}
+
+bool Queue::waitFor(uint64_t value, std::chrono::nanoseconds timeout)
+{
+    vk::SemaphoreWaitInfo info = {};
+    info.setSemaphoreCount(1);
+    info.setPSemaphores(&*m_timeline);
+    info.setPValues(&value);
+
+    // Blocks in the driver, no spinning.
+    const auto result = m_device.waitSemaphores(info, (uint64_t)timeout.count());
+    RAYGUN_ASSERT(result == vk::Result::eSuccess || result == vk::Result::eTimeout);
+
+    return result == vk::Result::eSuccess;
+}
+
+void Queue::onCompleted(uint64_t value, std::function<void()> callback)
+{
+    std::lock_guard lock(m_callbackMutex);
+
+    m_callbacks.emplace_back(value, std::move(callback));
+}
+
+void Queue::retireShared(uint64_t value, std::shared_ptr<void> resource)
+{
+    std::lock_guard lock(m_callbackMutex);
+
+    m_retired.emplace_back(value, std::move(resource));
+}
+
+void Queue::runCompletedCallbacks()
+{
+    RAYGUN_ASSERT(m_completedCallbacks.empty() && m_completedRetired.empty());
+
+    {
+        std::lock_guard lock(m_callbackMutex);
+
+        if(m_callbacks.empty() && m_retired.empty()) return;
+
+        const auto value = completedValue();
+        takeCompleted(m_callbacks, value, m_completedCallbacks);
+        takeCompleted(m_retired, value, m_completedRetired);
+    }
+
+    // Callbacks may schedule further callbacks.
+    for(auto& callback: m_completedCallbacks) {
+        callback();
+    }
+
+    m_completedCallbacks.clear();
+    m_completedRetired.clear();
 }
 
 void Queue::setupCommandPool()
@@ -69,8 +213,22 @@ void Queue::setupCommandPool()
     m_commandPool = m_device.createCommandPoolUnique(info);
 }
 
+void Queue::setupTimeline()
+{
+    vk::SemaphoreTypeCreateInfo typeInfo = {};
+    typeInfo.setSemaphoreType(vk::SemaphoreType::eTimeline);
+    typeInfo.setInitialValue(0);
+
+    vk::SemaphoreCreateInfo info = {};
+    info.setPNext(&typeInfo);
+
+    m_timeline = m_device.createSemaphoreUnique(info);
+}
+
 void Queue::waitIdle()
 {
+    std::lock_guard lock(*m_submitMutex);
+
     m_queue.waitIdle();
 }
 
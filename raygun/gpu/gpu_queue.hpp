@@ -20,26 +20,71 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+
 #pragma once
 
 namespace raygun::gpu {
 
 /// Utility class wrapping Vulkan queues and related operations.
+///
+/// Every submission signals the queue's timeline semaphore with a new,
+/// increasing value. Waiting for a submission means waiting for its value.
+///
+/// Vulkan requires access to a VkQueue to be externally synchronized.
+/// Wrappers of the same VkQueue must therefore share one submit mutex.
 class Queue {
   public:
-    Queue(const vk::Device& device, uint32_t familyIndex);
+    Queue(const vk::Device& device, uint32_t familyIndex, std::shared_ptr<std::mutex> submitMutex);
 
     uint32_t familyIndex() const { return m_familyIndex; }
 
     vk::Queue& queue() { return m_queue; }
 
+    vk::Semaphore& timeline() { return *m_timeline; }
+
     vk::CommandPool& commandPool() { return *m_commandPool; }
 
     vk::UniqueCommandBuffer createCommandBuffer();
 
-    void submit(vk::ArrayProxy<const vk::CommandBuffer> cmds, vk::Fence fence = {}, vk::ArrayProxy<const vk::Semaphore> signalSemaphores = {},
-                vk::ArrayProxy<const vk::Semaphore> waitSemaphores = {});
-    void submit(vk::ArrayProxy<const vk::SubmitInfo> infos, vk::Fence fence = {});
+    /// Submissions are thread-safe. Returns the timeline value signaled once
+    /// the given command buffers have been executed.
+    uint64_t submit(vk::ArrayProxy<const vk::CommandBuffer> cmds, vk::ArrayProxy<const vk::Semaphore> waitSemaphores = {},
+                    vk::ArrayProxy<const vk::PipelineStageFlags> waitStages = {}, vk::ArrayProxy<const vk::Semaphore> signalSemaphores = {});
+
+    /// Presents under the submit mutex, like submit. Throws like
+    /// vk::Queue::presentKHR.
+    vk::Result present(const vk::PresentInfoKHR& info);
+
+    /// Value of the latest submission.
+    uint64_t submittedValue() const { return m_submittedValue; }
+
+    /// Value of the latest submission executed by the GPU.
+    uint64_t completedValue() const;
+
+    /// Blocks until the GPU has passed the given value. Long waits are
+    /// reported, a GPU which does not make progress is fatal.
+    void wait(uint64_t value);
+
+    /// Returns false if the GPU has not passed the given value in time.
+    bool waitFor(uint64_t value, std::chrono::nanoseconds timeout);
+
+    /// Schedules CPU work to run after the GPU has passed the given value.
+    /// Callbacks are invoked by runCompletedCallbacks.
+    void onCompleted(uint64_t value, std::function<void()> callback);
+
+    /// Runs callbacks and releases resources whose value has been passed.
+    /// Storage is reused, so this does not allocate once warmed up.
+    void runCompletedCallbacks();
+
+    /// Keeps the given resource alive until the GPU has passed the given
+    /// value.
+    template<typename T>
+    void retire(uint64_t value, T resource)
+    {
+        retireShared(value, std::make_shared<T>(std::move(resource)));
+    }
+
+    void retireShared(uint64_t value, std::shared_ptr<void> resource);
 
     void waitIdle();
 
@@ -50,9 +95,23 @@ class Queue {
 
     vk::UniqueCommandPool m_commandPool;
 
+    vk::UniqueSemaphore m_timeline;
+
+    std::shared_ptr<std::mutex> m_submitMutex;
+    std::atomic<uint64_t> m_submittedValue = 0;
+
+    std::mutex m_callbackMutex;
+    std::vector<std::pair<uint64_t, std::function<void()>>> m_callbacks;
+    std::vector<std::pair<uint64_t, std::shared_ptr<void>>> m_retired;
+
+    // Completed entries are moved here and processed outside the lock.
+    std::vector<std::function<void()>> m_completedCallbacks;
+    std::vector<std::shared_ptr<void>> m_completedRetired;
+
     const vk::Device& m_device;
 
     void setupCommandPool();
+    void setupTimeline();
 };
 
 using UniqueQueue = std::unique_ptr<Queue>;
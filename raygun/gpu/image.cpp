@@ -28,6 +28,18 @@
 namespace raygun::gpu {
 
 Image::Image(vk::Extent2D extent, vk::Format format, uint32_t numMipLayers, vk::SampleCountFlagBits samples, vk::ImageLayout layout)
+    : Image(extent, format, numMipLayers, samples, layout, nullptr)
+{
+}
+
+Image::Image(CommandBatch& batch, vk::Extent2D extent, vk::Format format, uint32_t numMipLayers, vk::SampleCountFlagBits samples,
+             vk::ImageLayout layout)
+    : Image(extent, format, numMipLayers, samples, layout, &batch)
+{
+}
+
+Image::Image(vk::Extent2D extent, vk::Format format, uint32_t numMipLayers, vk::SampleCountFlagBits samples, vk::ImageLayout layout,
+             CommandBatch* batch)
     : m_extent(extent)
     , m_format(format)
     , m_numMips(numMipLayers)
@@ -43,29 +55,13 @@ Image::Image(vk::Extent2D extent, vk::Format format, uint32_t numMipLayers, vk::
 
     setupImageViews();
 
-    // barrier
-    {
-        auto cmd = vc.graphicsQueue->createCommandBuffer();
-        vc.setObjectName(*cmd, "Image Constructor");
-
-        auto fence = vc.device->createFenceUnique({});
-        vc.setObjectName(*fence, "Image Constructor");
-
-        vk::CommandBufferBeginInfo beginInfo;
-        beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-        cmd->begin(beginInfo);
-
-        vk::ImageMemoryBarrier barr;
-        barr.setImage(*m_image);
-        barr.setOldLayout(vk::ImageLayout::eUndefined);
-        barr.setNewLayout(layout);
-        barr.setSubresourceRange(mipImageSubresourceRange(0, m_numMips));
-
-        cmd->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, vk::DependencyFlagBits::eByRegion, {}, {}, barr);
-
-        cmd->end();
-        vc.graphicsQueue->submit(*cmd, *fence);
-        vc.waitForFence(*fence);
+    if(batch) {
+        batch->imageLayoutTransition(*m_image, vk::ImageLayout::eUndefined, layout, mipImageSubresourceRange(0, m_numMips));
+    }
+    else {
+        CommandBatch ownBatch(*vc.graphicsQueue, "Image Constructor");
+        ownBatch.imageLayoutTransition(*m_image, vk::ImageLayout::eUndefined, layout, mipImageSubresourceRange(0, m_numMips));
+        ownBatch.submit().wait();
     }
 
     {
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "raygun/gpu/command_batch.hpp"
 #include "raygun/vulkan_context.hpp"
 
 namespace raygun::gpu {
@@ -31,6 +32,11 @@ class Image {
     Image(vk::Extent2D extent, vk::Format format = vk::Format::eR16G16B16A16Sfloat, uint32_t numMipLayers = 1,
           vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1, vk::ImageLayout initialLayout = vk::ImageLayout::eGeneral);
 
+    /// Records the initial layout transition into the given batch, the image
+    /// must not be used before the batch has been executed.
+    Image(CommandBatch& batch, vk::Extent2D extent, vk::Format format = vk::Format::eR16G16B16A16Sfloat, uint32_t numMipLayers = 1,
+          vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1, vk::ImageLayout initialLayout = vk::ImageLayout::eGeneral);
+
     operator vk::Image() const { return *m_image; }
 
     const vk::Extent2D& extent() const { return m_extent; }
@@ -47,6 +53,9 @@ class Image {
     void setName(string_view name);
 
   private:
+    Image(vk::Extent2D extent, vk::Format format, uint32_t numMipLayers, vk::SampleCountFlagBits samples, vk::ImageLayout initialLayout,
+          CommandBatch* batch);
+
     vk::Extent2D m_extent;
     vk::Format m_format;
     uint32_t m_numMips;
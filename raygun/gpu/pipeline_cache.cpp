@@ -0,0 +1,152 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/gpu/pipeline_cache.hpp"
+
+#include "raygun/logging.hpp"
+
+namespace raygun::gpu {
+
+namespace {
+
+    /// Upper bound for the cache data read from disk, anything larger is
+    /// considered corrupt.
+    constexpr uint64_t MAX_DATA_SIZE = 256 * 1024 * 1024;
+
+    /// Prepended to the cache data written to disk. The header Vulkan puts
+    /// in front of the cache data does not contain the driver version.
+    struct FileHeader {
+        char magic[4] = {'R', 'G', 'P', 'C'};
+        uint32_t vendorID = 0;
+        uint32_t deviceID = 0;
+        uint32_t driverVersion = 0;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+        uint64_t dataSize = 0;
+
+        FileHeader() = default;
+
+        FileHeader(const vk::PhysicalDeviceProperties& properties, uint64_t dataSize)
+            : vendorID(properties.vendorID)
+            , deviceID(properties.deviceID)
+            , driverVersion(properties.driverVersion)
+            , dataSize(dataSize)
+        {
+            memcpy(pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+        }
+
+        bool compatible(const FileHeader& other) const
+        {
+            return memcmp(magic, other.magic, sizeof(magic)) == 0 && vendorID == other.vendorID && deviceID == other.deviceID
+                   && driverVersion == other.driverVersion && memcmp(pipelineCacheUUID, other.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+    };
+
+} // namespace
+
+PipelineCache::PipelineCache(const vk::Device& device, const vk::PhysicalDeviceProperties& properties, fs::path path)
+    : m_path(std::move(path))
+    , m_device(device)
+    , m_properties(properties)
+{
+    const auto startTime = Clock::now();
+
+    const auto data = load();
+    m_warm = !data.empty();
+
+    vk::PipelineCacheCreateInfo info = {};
+    info.setInitialDataSize(data.size());
+    info.setPInitialData(data.data());
+
+    m_cache = m_device.createPipelineCacheUnique(info);
+
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_INFO("Pipeline cache initialized ({}, {} bytes) in {:.2f} ms", m_warm ? "warm" : "cold", data.size(), duration.count());
+}
+
+void PipelineCache::save()
+{
+    const auto data = m_device.getPipelineCacheData(*m_cache);
+
+    const FileHeader header(m_properties, data.size());
+
+    // Write to a temporary file first so a crash does not leave a truncated
+    // cache behind.
+    auto tempPath = m_path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if(!out) {
+            RAYGUN_WARN("Unable to write pipeline cache: {}", tempPath);
+            return;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    std::error_code err;
+    fs::rename(tempPath, m_path, err);
+    if(err) {
+        RAYGUN_WARN("Unable to write pipeline cache: {}", err.message());
+        return;
+    }
+
+    RAYGUN_DEBUG("Pipeline cache saved ({} bytes)", data.size());
+}
+
+std::vector<char> PipelineCache::load()
+{
+    std::ifstream in(m_path, std::ios::binary);
+    if(!in) {
+        return {};
+    }
+
+    FileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if(!in || !header.compatible(FileHeader(m_properties, 0))) {
+        RAYGUN_INFO("Discarding pipeline cache created by a different device or driver");
+        return {};
+    }
+
+    // Do not trust the header with the allocation size.
+    std::error_code err;
+    const auto fileSize = fs::file_size(m_path, err);
+    if(err || header.dataSize > MAX_DATA_SIZE || header.dataSize != fileSize - sizeof(header)) {
+        RAYGUN_WARN("Discarding corrupt pipeline cache");
+        return {};
+    }
+
+    std::vector<char> data(header.dataSize);
+    in.read(data.data(), data.size());
+
+    if(!in) {
+        RAYGUN_WARN("Discarding truncated pipeline cache");
+        return {};
+    }
+
+    return data;
+}
+
+} // namespace raygun::gpu
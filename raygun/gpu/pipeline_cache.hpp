@@ -0,0 +1,57 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+namespace raygun::gpu {
+
+/// Vulkan pipeline cache persisted on disk. Data stored on disk is only used
+/// if it has been created by the same device and driver version.
+class PipelineCache {
+  public:
+    PipelineCache(const vk::Device& device, const vk::PhysicalDeviceProperties& properties, fs::path path);
+
+    /// Writes the current cache content to disk.
+    void save();
+
+    /// True if valid cache data has been loaded from disk.
+    bool warm() const { return m_warm; }
+
+    vk::PipelineCache& cache() { return *m_cache; }
+
+  private:
+    std::vector<char> load();
+
+    fs::path m_path;
+
+    bool m_warm = false;
+
+    vk::UniquePipelineCache m_cache;
+
+    const vk::Device& m_device;
+    const vk::PhysicalDeviceProperties& m_properties;
+};
+
+using UniquePipelineCache = std::unique_ptr<PipelineCache>;
+
+} // namespace raygun::gpu
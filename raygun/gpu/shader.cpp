@@ -54,22 +54,4 @@ vk::PipelineShaderStageCreateInfo Shader::shaderStageInfo(vk::ShaderStageFlagBit
     return info;
 }
 
-void recompileAllShaders()
-{
-    const auto shaderDir = fs::path{"resources/shaders"};
-    const std::set<fs::path> extensions = {".rgen", ".rint", ".rahit", ".rchit", ".rmiss", ".rcall"};
-
-    for(const auto& entry: fs::directory_iterator(shaderDir)) {
-        if(extensions.find(entry.path().extension()) == extensions.end()) continue;
-
-        const auto cmd = fmt::format("glslc.exe --target-env=vulkan1.2 -o {0}.spv {0}", entry.path());
-        if(system(cmd.c_str()) != 0) {
-            RAYGUN_WARN("Compiling {} failed", entry.path());
-        }
-        else {
-            RAYGUN_INFO("Compiled {}", entry.path());
-        }
-    }
-}
-
 } // namespace raygun::gpu
@@ -32,6 +32,4 @@ struct Shader {
     vk::UniqueShaderModule shaderModule;
 };
 
-void recompileAllShaders();
-
 } // namespace raygun::gpu
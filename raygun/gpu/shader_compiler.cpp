@@ -0,0 +1,388 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/gpu/shader_compiler.hpp"
+
+#include "raygun/logging.hpp"
+#include "raygun/utils/hash_utils.hpp"
+#include "raygun/utils/io_utils.hpp"
+
+namespace raygun::gpu {
+
+namespace {
+
+    /// Bump this when compile options change to invalidate the cache.
+    constexpr uint64_t COMPILER_VERSION = 1;
+
+    /// Target environment of both backends, part of the cache key.
+    constexpr string_view TARGET_ENV = "vulkan1.2";
+
+#ifdef RAYGUN_SHADERC
+    constexpr string_view BACKEND = "shaderc";
+#else
+    constexpr string_view BACKEND = "glslc";
+#endif
+
+    const std::set<fs::path> SHADER_EXTENSIONS = {".vert", ".frag", ".comp", ".rgen", ".rint", ".rahit", ".rchit", ".rmiss", ".rcall"};
+
+    string readText(const fs::path& path)
+    {
+        const auto data = io::readFile(path);
+        return string(data.begin(), data.end());
+    }
+
+    /// Includes are looked up relative to the including file first, then in
+    /// the shader directory.
+    fs::path resolveInclude(const fs::path& shaderDir, const fs::path& includingFile, const fs::path& requested)
+    {
+        const auto relative = includingFile.parent_path() / requested;
+        if(fs::exists(relative)) {
+            return relative;
+        }
+        return shaderDir / requested;
+    }
+
+    std::vector<fs::path> directIncludes(const string& source)
+    {
+        static const std::regex includeRegex(R"re(^\s*#\s*include\s*"([^"]+)")re");
+
+        std::vector<fs::path> result;
+
+        std::istringstream in(source);
+        string line;
+        while(std::getline(in, line)) {
+            std::smatch match;
+            if(std::regex_search(line, match, includeRegex)) {
+                result.emplace_back(match[1].str());
+            }
+        }
+
+        return result;
+    }
+
+#ifdef RAYGUN_SHADERC
+    class Includer : public shaderc::CompileOptions::IncluderInterface {
+      public:
+        Includer(fs::path shaderDir) : m_shaderDir(std::move(shaderDir)) {}
+
+        shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type, const char* requestingSource, size_t) override
+        {
+            auto include = new Include;
+
+            const auto path = resolveInclude(m_shaderDir, requestingSource, requestedSource);
+            try {
+                include->content = readText(path);
+                include->name = path.string();
+            }
+            catch(const std::exception& e) {
+                // An empty name signals failure, content holds the message.
+                include->content = e.what();
+            }
+
+            include->result.source_name = include->name.data();
+            include->result.source_name_length = include->name.size();
+            include->result.content = include->content.data();
+            include->result.content_length = include->content.size();
+            include->result.user_data = include;
+
+            return &include->result;
+        }
+
+        void ReleaseInclude(shaderc_include_result* result) override { delete static_cast<Include*>(result->user_data); }
+
+      private:
+        struct Include {
+            string name;
+            string content;
+            shaderc_include_result result = {};
+        };
+
+        fs::path m_shaderDir;
+    };
+
+    shaderc_shader_kind shaderKind(const fs::path& source)
+    {
+        const auto ext = source.extension();
+
+        if(ext == ".vert") return shaderc_vertex_shader;
+        if(ext == ".frag") return shaderc_fragment_shader;
+        if(ext == ".comp") return shaderc_compute_shader;
+        if(ext == ".rgen") return shaderc_raygen_shader;
+        if(ext == ".rint") return shaderc_intersection_shader;
+        if(ext == ".rahit") return shaderc_anyhit_shader;
+        if(ext == ".rchit") return shaderc_closesthit_shader;
+        if(ext == ".rmiss") return shaderc_miss_shader;
+        if(ext == ".rcall") return shaderc_callable_shader;
+
+        return shaderc_glsl_infer_from_source;
+    }
+#endif
+
+} // namespace
+
+ShaderCompiler::ShaderCompiler(fs::path shaderDir, fs::path cacheDir) : m_shaderDir(std::move(shaderDir)), m_cacheDir(std::move(cacheDir))
+{
+    std::error_code err;
+    fs::create_directories(m_cacheDir, err);
+    if(err) {
+        RAYGUN_WARN("Unable to create shader cache directory: {}", m_cacheDir);
+    }
+
+    // Deployed SPIR-V is assumed to match the current sources, it has been
+    // built alongside the application.
+    for(const auto& source: shaderSources()) {
+        m_hashes[source.filename().string()] = hashShader(source);
+    }
+}
+
+std::set<string> ShaderCompiler::compileChanged()
+{
+    const auto startTime = Clock::now();
+
+    std::vector<Job> jobs;
+    for(const auto& source: shaderSources()) {
+        Job job;
+        job.name = source.filename().string();
+        job.source = source;
+        job.hash = hashShader(source);
+
+        const auto it = m_hashes.find(job.name);
+        if(it != m_hashes.end() && it->second == job.hash) continue;
+
+        jobs.push_back(std::move(job));
+    }
+
+    // Compile on worker threads, each one picks the next pending job.
+    {
+        std::atomic<size_t> nextJob = 0;
+        const auto workerCount = std::min<size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+        std::vector<std::future<void>> workers;
+        for(size_t i = 0; i < workerCount; ++i) {
+            workers.push_back(std::async(std::launch::async, [&] {
+                for(auto j = nextJob++; j < jobs.size(); j = nextJob++) {
+                    compile(jobs[j]);
+                }
+            }));
+        }
+
+        for(auto& worker: workers) {
+            worker.get();
+        }
+    }
+
+    std::set<string> changed;
+    size_t cachedCount = 0;
+
+    for(const auto& job: jobs) {
+        if(!job.success) {
+            RAYGUN_WARN("Compiling {} failed:\n{}", job.name, job.error);
+            continue;
+        }
+
+        const auto output = m_shaderDir / (job.name + ".spv");
+
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        out.write(job.spirv.data(), job.spirv.size());
+        if(!out) {
+            RAYGUN_WARN("Unable to write {}", output);
+            continue;
+        }
+
+        m_hashes[job.name] = job.hash;
+        changed.insert(job.name);
+
+        if(job.cached) {
+            cachedCount++;
+        }
+
+        RAYGUN_INFO("Compiled {}{}", job.name, job.cached ? " (cached)" : "");
+    }
+
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_INFO("Updated {} of {} changed shaders ({} from cache) in {:.2f} ms", changed.size(), jobs.size(), cachedCount, duration.count());
+
+    return changed;
+}
+
+void ShaderCompiler::setDefine(const string& name, const string& value)
+{
+    m_defines[name] = value;
+}
+
+std::vector<fs::path> ShaderCompiler::shaderSources() const
+{
+    std::vector<fs::path> result;
+
+    std::error_code err;
+    for(const auto& entry: fs::directory_iterator(m_shaderDir, err)) {
+        if(SHADER_EXTENSIONS.find(entry.path().extension()) == SHADER_EXTENSIONS.end()) continue;
+        result.push_back(entry.path());
+    }
+
+    if(err) {
+        RAYGUN_WARN("Unable to list shaders in {}", m_shaderDir);
+    }
+
+    return result;
+}
+
+uint64_t ShaderCompiler::hashShader(const fs::path& source) const
+{
+    auto hash = utils::hashValue(COMPILER_VERSION);
+    hash = utils::hashString(TARGET_ENV, hash);
+    hash = utils::hashString(BACKEND, hash);
+
+    // The stage is derived from the extension, identical sources compiled
+    // for different stages must not share a cache entry.
+    hash = utils::hashString(source.extension().string(), hash);
+
+    for(const auto& [name, value]: m_defines) {
+        hash = utils::hashString(name, hash);
+        hash = utils::hashString(value, hash);
+    }
+
+    // Hash source and all (transitively) included files, each file once.
+    std::set<fs::path> visited;
+    std::vector<fs::path> pending = {source};
+
+    while(!pending.empty()) {
+        const auto path = pending.back();
+        pending.pop_back();
+
+        if(!visited.insert(fs::weakly_canonical(path)).second) continue;
+
+        string content;
+        try {
+            content = readText(path);
+        }
+        catch(const std::exception&) {
+            // Missing includes are reported by the compiler.
+            hash = utils::hashString(path.string(), hash);
+            continue;
+        }
+
+        hash = utils::hashString(content, hash);
+
+        for(const auto& include: directIncludes(content)) {
+            pending.push_back(resolveInclude(m_shaderDir, path, include));
+        }
+    }
+
+    return hash;
+}
+
+void ShaderCompiler::compile(Job& job) const
+{
+    const auto cachePath = m_cacheDir / fmt::format("{:016x}.spv", job.hash);
+    // Jobs with identical sources share the hash, the name keeps their
+    // temporary files apart.
+    const auto tempPath = m_cacheDir / fmt::format("{:016x}.{}.spv.tmp", job.hash, job.name);
+
+    if(fs::exists(cachePath)) {
+        try {
+            job.spirv = io::readFile(cachePath);
+            job.cached = true;
+            job.success = true;
+            return;
+        }
+        catch(const std::exception&) {
+            // fall through and compile
+        }
+    }
+
+#ifdef RAYGUN_SHADERC
+    string source;
+    try {
+        source = readText(job.source);
+    }
+    catch(const std::exception& e) {
+        job.error = e.what();
+        return;
+    }
+
+    shaderc::CompileOptions options;
+    // Matches TARGET_ENV.
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+    options.SetIncluder(std::make_unique<Includer>(m_shaderDir));
+    for(const auto& [name, value]: m_defines) {
+        options.AddMacroDefinition(name, value);
+    }
+
+    const shaderc::Compiler compiler;
+    const auto result = compiler.CompileGlslToSpv(source, shaderKind(job.source), job.source.string().c_str(), options);
+
+    if(result.GetCompilationStatus() != shaderc_compilation_status_success) {
+        job.error = result.GetErrorMessage();
+        return;
+    }
+
+    job.spirv.assign(reinterpret_cast<const char*>(result.cbegin()), reinterpret_cast<const char*>(result.cend()));
+
+    bool written = false;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(job.spirv.data(), job.spirv.size());
+        written = out.good();
+    }
+
+    if(!written) {
+        RAYGUN_WARN("Unable to write shader cache file: {}", tempPath);
+        std::error_code err;
+        fs::remove(tempPath, err);
+        job.success = true;
+        return;
+    }
+#else
+    string defines;
+    for(const auto& [name, value]: m_defines) {
+        defines += value.empty() ? fmt::format(" -D{}", name) : fmt::format(" -D{}={}", name, value);
+    }
+
+    const auto cmd = fmt::format("glslc --target-env={}{} -o \"{}\" \"{}\"", TARGET_ENV, defines, tempPath.string(), job.source.string());
+    if(std::system(cmd.c_str()) != 0) {
+        job.error = "glslc failed";
+        return;
+    }
+
+    try {
+        job.spirv = io::readFile(tempPath);
+    }
+    catch(const std::exception& e) {
+        job.error = e.what();
+        return;
+    }
+#endif
+
+    // Only complete files end up in the cache.
+    std::error_code err;
+    fs::rename(tempPath, cachePath, err);
+    if(err) {
+        RAYGUN_WARN("Unable to store {} in shader cache: {}", job.name, err.message());
+        fs::remove(tempPath, err);
+    }
+
+    job.success = true;
+}
+
+} // namespace raygun::gpu
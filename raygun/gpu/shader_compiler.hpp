@@ -0,0 +1,75 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+namespace raygun::gpu {
+
+/// Compiles GLSL shaders to SPIR-V. Results are stored in a cache on disk,
+/// keyed by a hash over the shader source, all included files, its stage and
+/// the compile options including defines.
+///
+/// Uses shaderc in-process when available (RAYGUN_SHADERC), glslc otherwise.
+class ShaderCompiler {
+  public:
+    ShaderCompiler(fs::path shaderDir, fs::path cacheDir);
+
+    /// Compiles all shaders whose source, includes or defines changed since
+    /// the last call. Changed shaders are compiled in parallel. Returns the
+    /// names of the shaders which have been updated, e.g. "raygen.rgen".
+    std::set<string> compileChanged();
+
+    /// Defines are passed to all shaders. Shaders are recompiled on the next
+    /// call to compileChanged.
+    void setDefine(const string& name, const string& value = "");
+
+  private:
+    struct Job {
+        string name;
+        fs::path source;
+        uint64_t hash = 0;
+
+        bool success = false;
+        bool cached = false;
+        std::vector<char> spirv;
+        string error;
+    };
+
+    std::vector<fs::path> shaderSources() const;
+
+    uint64_t hashShader(const fs::path& source) const;
+
+    void compile(Job& job) const;
+
+    fs::path m_shaderDir;
+    fs::path m_cacheDir;
+
+    std::map<string, string> m_defines;
+
+    /// Hashes of the shaders currently deployed to the shader directory.
+    std::map<string, uint64_t> m_hashes;
+};
+
+using UniqueShaderCompiler = std::unique_ptr<ShaderCompiler>;
+
+} // namespace raygun::gpu
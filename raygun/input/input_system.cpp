@@ -22,7 +22,6 @@
 
 #include "raygun/input/input_system.hpp"
 
-#include "raygun/gpu/shader.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
 
@@ -51,9 +50,14 @@ Input InputSystem::handleEvents()
         }
 
         if(pressed(GLFW_KEY_F6)) {
-            RG().resourceManager().clearShaderCache();
-            gpu::recompileAllShaders();
-            RG().renderSystem().reload();
+            const auto changedShaders = RG().resourceManager().recompileShaders();
+            if(!changedShaders.empty()) {
+                RG().renderSystem().reloadShaders(changedShaders);
+            }
+        }
+
+        if(pressed(GLFW_KEY_F8) && !RG().profiler().capturingTrace()) {
+            RG().profiler().captureTrace((uint32_t)RG().config().traceFrames);
         }
 
         if(pressed(GLFW_KEY_F10)) {
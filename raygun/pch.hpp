@@ -37,24 +37,32 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
 #include <experimental/map>
 #include <experimental/set>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <queue>
+#include <random>
 #include <regex>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -72,6 +80,10 @@
 #define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
 #include <vulkan/vulkan.hpp>
 
+#ifdef RAYGUN_SHADERC
+    #include <shaderc/shaderc.hpp>
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 
 #define GLFW_INCLUDE_NONE
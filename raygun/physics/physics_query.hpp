@@ -0,0 +1,65 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/entity.hpp"
+#include "raygun/transform.hpp"
+
+namespace raygun::physics {
+
+/// Scene query types used with the batched query functions of
+/// PhysicsSystem.
+
+struct Ray {
+    vec3 origin = {};
+    vec3 direction = {0.0f, 0.0f, -1.0f}; ///< Normalized.
+    float maxDistance = 100.0f;
+};
+
+struct Sweep {
+    physx::PxGeometryHolder geometry;
+    Transform pose; ///< Scaling is ignored.
+    vec3 direction = {0.0f, 0.0f, -1.0f}; ///< Normalized.
+    float maxDistance = 100.0f;
+};
+
+struct Overlap {
+    physx::PxGeometryHolder geometry;
+    Transform pose; ///< Scaling is ignored.
+};
+
+/// Closest hit of a ray or sweep. For overlaps, only hit and entity are set.
+struct QueryHit {
+    bool hit = false;
+
+    /// Entity of the actor hit, nullptr for actors not belonging to an
+    /// entity.
+    Entity* entity = nullptr;
+
+    vec3 position = {};
+    vec3 normal = {};
+    float distance = 0.0f;
+};
+
+} // namespace raygun::physics
@@ -25,20 +25,40 @@
 #include "raygun/assert.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/material.hpp"
+#include "raygun/physics/physics_utils.hpp"
+#include "raygun/profiler_zones.hpp"
 
 using namespace physx;
 
 namespace raygun::physics {
 
+namespace {
+
+    Material* materialAt(const PxShape* shape, PxU32 faceIndex)
+    {
+        if(faceIndex == PXC_CONTACT_NO_FACE_INDEX) return nullptr;
+
+        const auto material = shape->getMaterialFromInternalFaceIndex(faceIndex);
+        return material ? static_cast<Material*>(material->userData) : nullptr;
+    }
+
+} // namespace
+
+SimCallback::SimCallback()
+{
+    m_triggerBuffer.reserve(INITIAL_EVENT_CAPACITY);
+    m_contactBuffer.reserve(INITIAL_EVENT_CAPACITY);
+    m_contactPointBuffer.reserve(INITIAL_EVENT_CAPACITY * MAX_CONTACT_POINTS);
+}
+
 void SimCallback::onTrigger(PxTriggerPair* pairs, PxU32 count)
 {
-    for(unsigned i = 0; i < count; ++i) {
-        auto p = pairs[i];
-        auto handler = triggerEvents.find(p.triggerActor);
-        if(handler != triggerEvents.end()) {
-            if(!handler->second(p)) {
-                break;
-            }
+    for(PxU32 i = 0; i < count; ++i) {
+        const auto& pair = pairs[i];
+        if(pair.flags & (PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER | PxTriggerPairFlag::eREMOVED_SHAPE_OTHER)) continue;
+
+        if(triggerEvents.count(pair.triggerActor) > 0) {
+            m_triggerBuffer.push_back(pair);
         }
         else {
             RAYGUN_TRACE("Unhandled trigger");
@@ -46,42 +66,108 @@ void SimCallback::onTrigger(PxTriggerPair* pairs, PxU32 count)
     }
 }
 
-void SimCallback::onContact(const PxContactPairHeader& header, const PxContactPair* pairs, [[maybe_unused]] PxU32 count)
+void SimCallback::onContact(const PxContactPairHeader& header, const PxContactPair* pairs, PxU32 count)
 {
-    RAYGUN_ASSERT(count > 0);
-    const auto& pair = pairs[0];
+    if(header.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | PxContactPairHeaderFlag::eREMOVED_ACTOR_1)) return;
 
-    auto touch = Touch::Found;
-    if(pair.events & PxPairFlag::eNOTIFY_TOUCH_PERSISTS) {
-        touch = Touch::Persist;
-    }
-    else if(pair.events & PxPairFlag::eNOTIFY_TOUCH_LOST) {
-        touch = Touch::Lost;
+    if(contactEvents.count(header.actors[0]) == 0 && contactEvents.count(header.actors[1]) == 0) return;
+
+    PxContactPairPoint points[MAX_CONTACT_POINTS];
+
+    for(PxU32 i = 0; i < count; ++i) {
+        const auto& pair = pairs[i];
+
+        auto touch = Touch::Found;
+        if(pair.events & PxPairFlag::eNOTIFY_TOUCH_PERSISTS) {
+            touch = Touch::Persist;
+        }
+        else if(pair.events & PxPairFlag::eNOTIFY_TOUCH_LOST) {
+            touch = Touch::Lost;
+        }
+
+        const auto pointCount = pair.extractContacts(points, MAX_CONTACT_POINTS);
+
+        ContactEvent event = {};
+        event.actors[0] = header.actors[0];
+        event.actors[1] = header.actors[1];
+        event.touch = touch;
+        event.firstPoint = (uint32_t)m_contactPointBuffer.size();
+        event.pointCount = pointCount;
+
+        // Shapes are only valid during the callback, the material of the
+        // first contact point is used.
+        if(touch != Touch::Lost && pointCount > 0 && !(pair.flags & (PxContactPairFlag::eREMOVED_SHAPE_0 | PxContactPairFlag::eREMOVED_SHAPE_1))) {
+            event.materials[0] = materialAt(pair.shapes[0], points[0].internalFaceIndex0);
+            event.materials[1] = materialAt(pair.shapes[1], points[0].internalFaceIndex1);
+        }
+
+        for(PxU32 p = 0; p < pointCount; ++p) {
+            m_contactPointBuffer.push_back({toVec3(points[p].position), toVec3(points[p].normal), toVec3(points[p].impulse), points[p].separation});
+        }
+
+        m_contactBuffer.push_back(event);
     }
+}
+
+void SimCallback::dispatchEvents()
+{
+    RAYGUN_PROFILE_ZONE("Dispatch Events");
 
-    PxContactPairPoint contact = {};
-    pair.extractContacts(&contact, 1);
+    for(const auto& pair: m_triggerBuffer) {
+        if(!pair.triggerActor) continue;
 
-    if(auto it = contactEvents.find(header.actors[0]); it != contactEvents.end()) {
-        auto& other = *static_cast<Entity*>(header.actors[1]->userData);
+        const auto it = triggerEvents.find(pair.triggerActor);
+        if(it == triggerEvents.end()) continue;
 
-        Material* material = nullptr;
-        if(touch != Touch::Lost && contact.internalFaceIndex1 != PXC_CONTACT_NO_FACE_INDEX) {
-            material = static_cast<Material*>(pair.shapes[1]->getMaterialFromInternalFaceIndex(contact.internalFaceIndex1)->userData);
+        // The handler may be removed while running.
+        const auto handler = it->second;
+        if(!handler(pair)) {
+            break;
         }
+    }
+
+    for(const auto& event: m_contactBuffer) {
+        for(int self = 0; self < 2; ++self) {
+            const auto other = 1 - self;
+            if(!event.actors[self] || !event.actors[other]) break;
+
+            const auto it = contactEvents.find(event.actors[self]);
+            if(it == contactEvents.end()) continue;
+
+            m_currentContactPoints.assign(m_contactPointBuffer.begin() + event.firstPoint,
+                                          m_contactPointBuffer.begin() + event.firstPoint + event.pointCount);
 
-        it->second(touch, other, material);
+            const auto handler = it->second;
+            handler(event.touch, *static_cast<Entity*>(event.actors[other]->userData), event.materials[other]);
+        }
     }
 
-    if(auto it = contactEvents.find(header.actors[1]); it != contactEvents.end()) {
-        auto& other = *static_cast<Entity*>(header.actors[0]->userData);
+    m_triggerBuffer.clear();
+    m_contactBuffer.clear();
+    m_contactPointBuffer.clear();
+    m_currentContactPoints.clear();
+}
 
-        Material* material = nullptr;
-        if(touch != Touch::Lost && contact.internalFaceIndex0 != PXC_CONTACT_NO_FACE_INDEX) {
-            material = static_cast<Material*>(pair.shapes[0]->getMaterialFromInternalFaceIndex(contact.internalFaceIndex0)->userData);
+void SimCallback::forgetActor(const PxActor* actor)
+{
+    triggerEvents.erase(actor);
+    contactEvents.erase(actor);
+
+    dropEvents(actor);
+}
+
+void SimCallback::dropEvents(const PxActor* actor)
+{
+    for(auto& pair: m_triggerBuffer) {
+        if(pair.triggerActor == actor || pair.otherActor == actor) {
+            pair.triggerActor = nullptr;
         }
+    }
 
-        it->second(touch, other, material);
+    for(auto& event: m_contactBuffer) {
+        if(event.actors[0] == actor || event.actors[1] == actor) {
+            event.actors[0] = event.actors[1] = nullptr;
+        }
     }
 }
 
@@ -36,8 +36,20 @@ enum class Touch { Found, Persist, Lost };
 /// Function to be executed when contact is found or lost.
 using ContactCallback = std::function<void(Touch touch, Entity& other, raygun::Material* otherMaterial)>;
 
+struct ContactPoint {
+    vec3 position;
+    vec3 normal;
+    vec3 impulse;
+    float separation;
+};
+
+/// Records trigger and contact events during the simulation. They are
+/// dispatched to the registered callbacks afterwards, so callbacks may modify
+/// the scene.
 class SimCallback : public physx::PxSimulationEventCallback {
   public:
+    SimCallback();
+
     virtual void onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count) override;
 
     virtual void onConstraintBreak(physx::PxConstraintInfo*, physx::PxU32) override {}
@@ -50,6 +62,22 @@ class SimCallback : public physx::PxSimulationEventCallback {
 
     virtual void onAdvance(const physx::PxRigidBody* const*, const physx::PxTransform*, const physx::PxU32) override {}
 
+    /// Invokes the callbacks for all events recorded since the last call.
+    void dispatchEvents();
+
+    /// Drops recorded events involving the given actor, as it is about to be
+    /// removed from its scene. Its callbacks are kept for when it is added
+    /// again.
+    void dropEvents(const physx::PxActor* actor);
+
+    /// Drops recorded events and callbacks involving the given actor, as it is
+    /// about to be released.
+    void forgetActor(const physx::PxActor* actor);
+
+    /// Contact points of the contact currently dispatched, valid during a
+    /// ContactCallback only.
+    const std::vector<ContactPoint>& contactPoints() const { return m_currentContactPoints; }
+
     void addTriggerEvent(const physx::PxActor* trigger, TriggerCallback handler);
 
     void clearTriggerEvents();
@@ -59,8 +87,28 @@ class SimCallback : public physx::PxSimulationEventCallback {
     void clearContactEvents();
 
   private:
-    std::map<const physx::PxActor*, TriggerCallback> triggerEvents;
+    /// Contact points recorded per contact pair at most.
+    static constexpr uint32_t MAX_CONTACT_POINTS = 4;
+
+    /// Initial capacity of the event buffers, they grow as needed.
+    static constexpr size_t INITIAL_EVENT_CAPACITY = 256;
+
+    struct ContactEvent {
+        const physx::PxActor* actors[2];
+        Touch touch;
+        raygun::Material* materials[2];
+        uint32_t firstPoint;
+        uint32_t pointCount;
+    };
+
+    std::unordered_map<const physx::PxActor*, TriggerCallback> triggerEvents;
+
+    std::unordered_map<const physx::PxActor*, ContactCallback> contactEvents;
+
+    std::vector<physx::PxTriggerPair> m_triggerBuffer;
+    std::vector<ContactEvent> m_contactBuffer;
+    std::vector<ContactPoint> m_contactPointBuffer;
 
-    std::map<const physx::PxActor*, ContactCallback> contactEvents;
+    std::vector<ContactPoint> m_currentContactPoints;
 };
 } // namespace raygun::physics
@@ -25,33 +25,33 @@
 #include "raygun/logging.hpp"
 #include "raygun/physics/physics_utils.hpp"
 #include "raygun/raygun.hpp"
+#include "raygun/transform_batch.hpp"
+#include "raygun/utils/hash_utils.hpp"
+#include "raygun/utils/io_utils.hpp"
 
 using namespace physx;
 
 namespace raygun::physics {
 
-PhysicsSystem::PhysicsSystem()
-    : m_foundation(PxCreateFoundation(PX_PHYSICS_VERSION, m_allocator, m_errorCallback))
-    , m_pvdTransport(PxDefaultPvdSocketTransportCreate("localhost", 5425, 10))
-    , m_pvd(PxCreatePvd(*m_foundation))
-    , m_physics(PxCreatePhysics(PX_PHYSICS_VERSION, *m_foundation, PxTolerancesScale(), true, m_pvd.get()))
-    , m_dispatcher(PxDefaultCpuDispatcherCreate(THREADS))
-    , m_cooking(PxCreateCooking(PX_PHYSICS_VERSION, *m_foundation, PxCookingParams(PxTolerancesScale())))
-    , m_defaultMaterial(m_physics->createMaterial(0.8f, 0.8f, 0.6f))
-{
-#ifndef NDEBUG
-    if(m_pvd->connect(*m_pvdTransport, PxPvdInstrumentationFlag::eALL)) {
-        RAYGUN_DEBUG("Connected to PhysX debugger");
-    }
-    else {
-        RAYGUN_DEBUG("Unable to connect to PhysX debugger");
-    }
-#endif
+namespace {
 
-    RAYGUN_INFO("Physics system initialized");
-}
+    PxU32 dispatcherThreads()
+    {
+        const auto threads = RG().config().physicsThreads;
+        if(threads >= 0) return (PxU32)threads;
 
-namespace {
+        return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    const char* broadphaseName(Config::PhysicsBroadphase broadphase)
+    {
+        switch(broadphase) {
+        case Config::PhysicsBroadphase::SAP: return "SAP";
+        case Config::PhysicsBroadphase::MBP: return "MBP";
+        case Config::PhysicsBroadphase::ABP: return "ABP";
+        }
+        return "unknown";
+    }
 
     PxFilterFlags filterShader(PxFilterObjectAttributes, PxFilterData, PxFilterObjectAttributes, PxFilterData, PxPairFlags& pairFlags, const void*, PxU32)
     {
@@ -60,33 +60,119 @@ namespace {
         return PxFilterFlag::eDEFAULT;
     }
 
+    /// Shapes leaving the MBP world bounds no longer collide.
+    class BroadPhaseCallback : public PxBroadPhaseCallback {
+      public:
+        void onObjectOutOfBounds(PxShape&, PxActor& actor) override
+        {
+            const auto entity = static_cast<Entity*>(actor.userData);
+            RAYGUN_WARN("Physics actor left the world bounds: {}", entity ? entity->name : "unnamed");
+        }
+
+        void onObjectOutOfBounds(PxAggregate&) override { RAYGUN_WARN("Physics aggregate left the world bounds"); }
+    };
+
+    BroadPhaseCallback broadPhaseCallback;
+
 } // namespace
 
+PhysicsSystem::PhysicsSystem()
+    : m_foundation(PxCreateFoundation(PX_PHYSICS_VERSION, m_allocator, m_errorCallback))
+    , m_pvdTransport(RG().config().physicsDebugger ? PxDefaultPvdSocketTransportCreate(PVD_HOST, PVD_PORT, PVD_TIMEOUT_MS) : nullptr)
+    , m_pvd(m_pvdTransport ? PxCreatePvd(*m_foundation) : nullptr)
+    , m_physics(PxCreatePhysics(PX_PHYSICS_VERSION, *m_foundation, PxTolerancesScale(), true, m_pvd.get()))
+    , m_dispatcher(PxDefaultCpuDispatcherCreate(dispatcherThreads()))
+    , m_cooking(PxCreateCooking(PX_PHYSICS_VERSION, *m_foundation, PxCookingParams(PxTolerancesScale())))
+    , m_defaultMaterial(m_physics->createMaterial(0.8f, 0.8f, 0.6f))
+    , m_meshCacheDir(configDirectory() / "physics_cache")
+    , m_simCallback(std::make_unique<SimCallback>())
+{
+    std::error_code err;
+    fs::create_directories(m_meshCacheDir, err);
+    if(err) {
+        RAYGUN_WARN("Unable to create physics cache directory: {}", m_meshCacheDir);
+    }
+
+    if(m_pvd) {
+        if(m_pvd->connect(*m_pvdTransport, PxPvdInstrumentationFlag::eALL)) {
+            RAYGUN_DEBUG("Connected to PhysX debugger");
+        }
+        else {
+            RAYGUN_DEBUG("Unable to connect to PhysX debugger");
+        }
+    }
+
+    const auto& config = RG().config();
+    RAYGUN_INFO("Physics system initialized ({} threads, {} broadphase, {} solver{})", m_dispatcher->getWorkerCount(),
+                broadphaseName(config.physicsBroadphase), config.physicsSolver == Config::PhysicsSolver::TGS ? "TGS" : "PGS",
+                config.physicsDeterminism ? ", deterministic" : "");
+}
+
 UniqueScene PhysicsSystem::createScene()
 {
+    const auto& config = RG().config();
+
     PxSceneDesc desc(m_physics->getTolerancesScale());
     desc.gravity = {0.0f, -9.81f, 0.0f};
     desc.cpuDispatcher = m_dispatcher.get();
     desc.filterShader = filterShader;
-    desc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+    desc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+
+    if(config.physicsDeterminism) {
+        desc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+    }
+
+    switch(config.physicsBroadphase) {
+    case Config::PhysicsBroadphase::SAP: desc.broadPhaseType = PxBroadPhaseType::eSAP; break;
+    case Config::PhysicsBroadphase::MBP: desc.broadPhaseType = PxBroadPhaseType::eMBP; break;
+    case Config::PhysicsBroadphase::ABP: desc.broadPhaseType = PxBroadPhaseType::eABP; break;
+    }
+    desc.broadPhaseCallback = &broadPhaseCallback;
+
+    desc.solverType = config.physicsSolver == Config::PhysicsSolver::TGS ? PxSolverType::eTGS : PxSolverType::ePGS;
 
     const auto scene = m_physics->createScene(desc);
 
-#ifndef NDEBUG
-    if(const auto pvdClient = scene->getScenePvdClient()) {
-        pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
-        pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONTACTS, true);
-        pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
+    // MBP requires at least one region before simulating.
+    if(desc.broadPhaseType == PxBroadPhaseType::eMBP) {
+        const auto extent = (float)config.physicsWorldExtent;
+        const auto subdivisions = (PxU32)std::clamp(config.physicsWorldSubdivisions, 1, 16);
+
+        std::vector<PxBounds3> regions(subdivisions * subdivisions);
+        PxBroadPhaseExt::createRegionsFromWorldBounds(regions.data(), PxBounds3(PxVec3(-extent), PxVec3(extent)), subdivisions);
+
+        for(const auto& bounds: regions) {
+            PxBroadPhaseRegion region;
+            region.bounds = bounds;
+            region.userData = nullptr;
+            scene->addBroadPhaseRegion(region);
+        }
+    }
+
+    if(m_pvd) {
+        if(const auto pvdClient = scene->getScenePvdClient()) {
+            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
+            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONTACTS, true);
+            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
+        }
     }
-#endif
 
-    m_simCallback = std::make_unique<SimCallback>();
+    // Shared by all scenes, so it outlives every one of them.
     scene->setSimulationEventCallback(&*m_simCallback);
 
     return wrapUnique(scene);
 }
 
 namespace {
+    uint32_t depth(const Entity& entity)
+    {
+        uint32_t result = 0;
+        for(auto parent = entity.parent(); parent; parent = parent->parent()) {
+            result++;
+        }
+        return result;
+    }
+
     void attachShape(PxRigidActor& actor, const Entity& entity, bool isTrigger, GeometryType geometryType, const PxMaterial& material)
     {
         auto flags = PxShapeFlag::eVISUALIZATION | PxShapeFlag::eSCENE_QUERY_SHAPE | PxShapeFlag::eSIMULATION_SHAPE;
@@ -112,15 +198,15 @@ namespace {
             break;
         }
         case GeometryType::ConvexMesh: {
-            const auto convexMesh = RG().physicsSystem().createConvexMesh(*entity.model->mesh);
-            PxConvexMeshGeometry geometry(convexMesh.get(), PxMeshScale(toVec3(entity.transform().scaling)));
+            const auto convexMesh = RG().physicsSystem().sharedConvexMesh(entity.model->mesh);
+            PxConvexMeshGeometry geometry(convexMesh, PxMeshScale(toVec3(entity.transform().scaling)));
             PxRigidActorExt::createExclusiveShape(actor, geometry, material, flags);
             break;
         }
         case GeometryType::TriangleMesh: {
-            const auto triangleMesh = RG().physicsSystem().createTriangleMesh(*entity.model->mesh);
+            const auto triangleMesh = RG().physicsSystem().sharedTriangleMesh(entity.model->mesh);
             const auto materials = collectPhysicsMaterials(entity.model->materials);
-            PxTriangleMeshGeometry geometry(triangleMesh.get(), PxMeshScale(toVec3(entity.transform().scaling)));
+            PxTriangleMeshGeometry geometry(triangleMesh, PxMeshScale(toVec3(entity.transform().scaling)));
             PxRigidActorExt::createExclusiveShape(actor, geometry, materials.data(), (PxU16)materials.size(), flags);
             break;
         }
@@ -134,11 +220,10 @@ void PhysicsSystem::attachRigidStatic(Entity& entity, GeometryType geometryType,
 
     auto actor = wrapUnique(m_physics->createRigidStatic(toTransform(entity.transform())));
     actor->setName(entity.name.c_str());
-    actor->userData = (void*)&entity;
 
     attachShape(*actor, entity, false, geometryType, *material);
 
-    entity.physicsActor = std::move(actor);
+    entity.setPhysicsActor(std::move(actor));
 }
 
 void PhysicsSystem::attachRigidDynamic(Entity& entity, bool isKinematic, GeometryType geometryType, PxMaterial* material)
@@ -147,13 +232,12 @@ void PhysicsSystem::attachRigidDynamic(Entity& entity, bool isKinematic, Geometr
 
     auto actor = wrapUnique(m_physics->createRigidDynamic(toTransform(entity.transform())));
     actor->setName(entity.name.c_str());
-    actor->userData = (void*)&entity;
 
     actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, isKinematic);
 
     attachShape(*actor, entity, false, geometryType, *material);
 
-    entity.physicsActor = std::move(actor);
+    entity.setPhysicsActor(std::move(actor));
 }
 
 void PhysicsSystem::makeTrigger(Entity& entity, TriggerCallback callback, GeometryType geometryType)
@@ -165,10 +249,161 @@ void PhysicsSystem::makeTrigger(Entity& entity, TriggerCallback callback, Geomet
 
     addTriggerEvent(actor.get(), callback);
 
-    entity.physicsActor = std::move(actor);
+    entity.setPhysicsActor(std::move(actor));
     entity.model.reset();
 }
 
+namespace {
+
+    /// Bump this when the cooking code changes to invalidate the cache.
+    constexpr uint32_t COOKED_MESH_CACHE_VERSION = 1;
+
+    /// Prepended to the cooked data written to disk.
+    struct CookedMeshHeader {
+        char magic[4] = {'R', 'G', 'C', 'M'};
+        uint32_t version = COOKED_MESH_CACHE_VERSION;
+        double cookingMs = 0.0;
+
+        /// Detects truncated or otherwise damaged files.
+        uint64_t dataSize = 0;
+        uint64_t dataHash = 0;
+
+        bool compatible(const CookedMeshHeader& other) const
+        {
+            return memcmp(magic, other.magic, sizeof(magic)) == 0 && version == other.version;
+        }
+    };
+
+    /// Only covers the parameters used by the mesh types cooked here.
+    uint64_t hashCookingParams(const PxCookingParams& params, uint64_t seed)
+    {
+        auto hash = utils::hashValue(PX_PHYSICS_VERSION, seed);
+        hash = utils::hashValue(COOKED_MESH_CACHE_VERSION, hash);
+        hash = utils::hashValue(params.scale.length, hash);
+        hash = utils::hashValue(params.scale.speed, hash);
+        hash = utils::hashValue(params.midphaseDesc.getType(), hash);
+        hash = utils::hashValue(params.midphaseDesc.mBVH34Desc.numPrimsPerLeaf, hash);
+        hash = utils::hashValue(params.suppressTriangleMeshRemapTable, hash);
+        hash = utils::hashValue((uint32_t)params.meshPreprocessParams, hash);
+        hash = utils::hashValue(params.meshWeldTolerance, hash);
+        hash = utils::hashValue(params.convexMeshCookingType, hash);
+        hash = utils::hashValue(params.gaussMapLimit, hash);
+        return hash;
+    }
+
+    uint64_t hashVertexPositions(const render::Mesh& mesh, uint64_t seed)
+    {
+        auto hash = utils::hashValue((uint64_t)mesh.vertices.size(), seed);
+        for(const auto& vertex: mesh.vertices) {
+            hash = utils::hashValue(vertex.position, hash);
+        }
+        return hash;
+    }
+
+    PxCookingParams triangleCookingParams(PxCookingParams params)
+    {
+        params.midphaseDesc = PxMeshMidPhase::eBVH34;
+        params.midphaseDesc.mBVH34Desc.numPrimsPerLeaf = 4;
+        params.suppressTriangleMeshRemapTable = true;
+        params.meshPreprocessParams |= PxMeshPreprocessingFlag::eWELD_VERTICES;
+        params.meshWeldTolerance = 0.05f;
+        return params;
+    }
+
+    PxCookingParams convexCookingParams(PxCookingParams params)
+    {
+        params.convexMeshCookingType = PxConvexMeshCookingType::eQUICKHULL;
+        params.gaussMapLimit = 16;
+        return params;
+    }
+
+} // namespace
+
+std::vector<uint8_t> PhysicsSystem::cookedMeshData(uint64_t key, string_view kind, const std::function<bool(PxOutputStream&)>& cook, bool readCache)
+{
+    const auto cachePath = m_meshCacheDir / fmt::format("{:016x}.{}", key, kind);
+    const auto tempPath = m_meshCacheDir / fmt::format("{:016x}.{}.tmp", key, kind);
+
+    if(RG().config().physicsMeshCache && readCache && fs::exists(cachePath)) {
+        const auto startTime = Clock::now();
+
+        try {
+            const auto file = io::readFile(cachePath);
+
+            CookedMeshHeader header;
+            if(file.size() > sizeof(header)) {
+                memcpy(&header, file.data(), sizeof(header));
+
+                if(header.compatible({})) {
+                    std::vector<uint8_t> data(file.begin() + sizeof(header), file.end());
+
+                    if(data.size() == header.dataSize && utils::hashVector(data) == header.dataHash) {
+                        const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+                        RAYGUN_INFO("Loaded cooked {} mesh {:016x} from cache in {:.2f} ms (cooking took {:.2f} ms)", kind, key, duration.count(),
+                                    header.cookingMs);
+
+                        return data;
+                    }
+
+                    RAYGUN_WARN("Discarding corrupt cooked {} mesh {:016x}", kind, key);
+                }
+            }
+        }
+        catch(const std::exception&) {
+            // fall through and cook
+        }
+    }
+
+    if(!readCache) {
+        std::error_code err;
+        fs::remove(cachePath, err);
+    }
+
+    const auto startTime = Clock::now();
+
+    PxDefaultMemoryOutputStream stream;
+    if(!cook(stream)) {
+        RAYGUN_ERROR("Unable to cook {} mesh", kind);
+        return {};
+    }
+
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_INFO("Cooked {} mesh {:016x} in {:.2f} ms", kind, key, duration.count());
+
+    std::vector<uint8_t> data(stream.getData(), stream.getData() + stream.getSize());
+
+    if(RG().config().physicsMeshCache) {
+        CookedMeshHeader header;
+        header.cookingMs = duration.count();
+        header.dataSize = data.size();
+        header.dataHash = utils::hashVector(data);
+
+        bool written = false;
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(data.data()), data.size());
+            written = out.good();
+        }
+
+        // Only complete files end up in the cache.
+        std::error_code err;
+        if(!written) {
+            RAYGUN_WARN("Unable to write cooked mesh cache file: {}", tempPath);
+            fs::remove(tempPath, err);
+        }
+        else {
+            fs::rename(tempPath, cachePath, err);
+            if(err) {
+                RAYGUN_WARN("Unable to store cooked {} mesh {:016x} in cache: {}", kind, key, err.message());
+                fs::remove(tempPath, err);
+            }
+        }
+    }
+
+    return data;
+}
+
 UniqueTriangleMesh PhysicsSystem::createTriangleMesh(const render::Mesh& mesh)
 {
     const auto materialIndices = getMaterialIndices(mesh);
@@ -183,15 +418,31 @@ UniqueTriangleMesh PhysicsSystem::createTriangleMesh(const render::Mesh& mesh)
     meshDesc.materialIndices.data = materialIndices.data();
     meshDesc.materialIndices.stride = sizeof(materialIndices[0]);
 
-    auto params = m_cooking->getParams();
-    params.midphaseDesc = PxMeshMidPhase::eBVH34;
-    params.midphaseDesc.mBVH34Desc.numPrimsPerLeaf = 4;
-    params.suppressTriangleMeshRemapTable = true;
-    params.meshPreprocessParams |= PxMeshPreprocessingFlag::eWELD_VERTICES;
-    params.meshWeldTolerance = 0.05f;
+    const auto params = triangleCookingParams(PxCookingParams(m_physics->getTolerancesScale()));
     m_cooking->setParams(params);
 
-    return wrapUnique(m_cooking->createTriangleMesh(meshDesc, m_physics->getPhysicsInsertionCallback()));
+    auto key = hashCookingParams(params, utils::hashString("triangle"));
+    key = hashVertexPositions(mesh, key);
+    key = utils::hashVector(mesh.indices, key);
+    key = utils::hashVector(materialIndices, key);
+
+    const auto cook = [&](PxOutputStream& stream) { return m_cooking->cookTriangleMesh(meshDesc, stream); };
+    const auto create = [&](bool readCache) -> UniqueTriangleMesh {
+        auto data = cookedMeshData(key, "tri", cook, readCache);
+        if(data.empty()) return {};
+
+        PxDefaultMemoryInputData input(data.data(), (PxU32)data.size());
+        return wrapUnique(m_physics->createTriangleMesh(input));
+    };
+
+    auto result = create(true);
+    if(!result && RG().config().physicsMeshCache) {
+        // Cached data PhysX rejects is replaced.
+        RAYGUN_WARN("Unable to create triangle mesh {:016x} from cooked data, cooking again", key);
+        result = create(false);
+    }
+
+    return result;
 }
 
 UniqueConvexMesh PhysicsSystem::createConvexMesh(const render::Mesh& mesh)
@@ -202,20 +453,237 @@ UniqueConvexMesh PhysicsSystem::createConvexMesh(const render::Mesh& mesh)
     desc.points.stride = sizeof(mesh.vertices[0]);
     desc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
 
-    auto params = m_cooking->getParams();
-    params.convexMeshCookingType = PxConvexMeshCookingType::eQUICKHULL;
-    params.gaussMapLimit = 16;
+    const auto params = convexCookingParams(PxCookingParams(m_physics->getTolerancesScale()));
     m_cooking->setParams(params);
 
-    return wrapUnique(m_cooking->createConvexMesh(desc, m_physics->getPhysicsInsertionCallback()));
+    auto key = hashCookingParams(params, utils::hashString("convex"));
+    key = hashVertexPositions(mesh, key);
+    key = utils::hashValue((uint32_t)desc.flags, key);
+
+    const auto cook = [&](PxOutputStream& stream) { return m_cooking->cookConvexMesh(desc, stream); };
+    const auto create = [&](bool readCache) -> UniqueConvexMesh {
+        auto data = cookedMeshData(key, "cvx", cook, readCache);
+        if(data.empty()) return {};
+
+        PxDefaultMemoryInputData input(data.data(), (PxU32)data.size());
+        return wrapUnique(m_physics->createConvexMesh(input));
+    };
+
+    auto result = create(true);
+    if(!result && RG().config().physicsMeshCache) {
+        // Cached data PhysX rejects is replaced.
+        RAYGUN_WARN("Unable to create convex mesh {:016x} from cooked data, cooking again", key);
+        result = create(false);
+    }
+
+    return result;
 }
 
-void PhysicsSystem::simulate(PxScene& scene, float timeDelta)
+PxTriangleMesh* PhysicsSystem::sharedTriangleMesh(const std::shared_ptr<render::Mesh>& mesh)
 {
-    if(m_paused) return;
+    const auto params = triangleCookingParams(PxCookingParams(m_physics->getTolerancesScale()));
+    const SharedMeshKey key = {mesh.get(), hashCookingParams(params, utils::FNV_OFFSET_BASIS)};
+
+    // Addresses of destroyed meshes may be reused.
+    auto& entry = m_sharedTriangleMeshes[key];
+    if(!entry.cooked || entry.mesh.lock() != mesh) {
+        entry.mesh = mesh;
+        entry.cooked = createTriangleMesh(*mesh);
+    }
+
+    return entry.cooked.get();
+}
+
+PxConvexMesh* PhysicsSystem::sharedConvexMesh(const std::shared_ptr<render::Mesh>& mesh)
+{
+    const auto params = convexCookingParams(PxCookingParams(m_physics->getTolerancesScale()));
+    const SharedMeshKey key = {mesh.get(), hashCookingParams(params, utils::FNV_OFFSET_BASIS)};
+
+    // Addresses of destroyed meshes may be reused.
+    auto& entry = m_sharedConvexMeshes[key];
+    if(!entry.cooked || entry.mesh.lock() != mesh) {
+        entry.mesh = mesh;
+        entry.cooked = createConvexMesh(*mesh);
+    }
+
+    return entry.cooked.get();
+}
 
-    scene.simulate(timeDelta);
-    scene.fetchResults(true);
+void PhysicsSystem::purgeSharedMeshes()
+{
+    // Shapes hold a reference to their mesh, the last reference is ours.
+    const auto unused = [](const auto& entry) { return !entry.second.cooked || entry.second.cooked->getReferenceCount() <= 1; };
+
+    const auto count = m_sharedTriangleMeshes.size() + m_sharedConvexMeshes.size();
+    std::experimental::erase_if(m_sharedTriangleMeshes, unused);
+    std::experimental::erase_if(m_sharedConvexMeshes, unused);
+
+    const auto purged = count - (m_sharedTriangleMeshes.size() + m_sharedConvexMeshes.size());
+    if(purged > 0) {
+        RAYGUN_DEBUG("Released {} unused collision meshes", purged);
+    }
+}
+
+namespace {
+
+    /// Queries per task, large enough to amortize scheduling.
+    constexpr size_t QUERY_CHUNK_SIZE = 256;
+
+    /// Upper bound for the tasks a batched query is split into.
+    constexpr size_t MAX_QUERY_TASKS = 32;
+
+    /// State of one batched query, shared by the calling thread and the
+    /// dispatcher's workers.
+    struct ChunkBatch {
+        size_t count = 0;
+        size_t chunkCount = 0;
+        std::atomic<size_t> nextChunk = 0;
+
+        void (*runChunk)(void* fun, size_t first, size_t last) = nullptr;
+        void* fun = nullptr;
+
+        std::mutex mutex;
+        std::condition_variable released;
+        size_t pendingTasks = 0;
+
+        /// Picks pending chunks until none are left.
+        void work()
+        {
+            for(auto chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                runChunk(fun, chunk * QUERY_CHUNK_SIZE, std::min(count, (chunk + 1) * QUERY_CHUNK_SIZE));
+            }
+        }
+    };
+
+    /// Lets a dispatcher worker join a batched query. The dispatcher releases
+    /// tasks once they have run.
+    class ChunkTask : public PxBaseTask {
+      public:
+        ChunkBatch* batch = nullptr;
+
+        void run() override { batch->work(); }
+        const char* getName() const override { return "Query Chunks"; }
+
+        void addReference() override {}
+        void removeReference() override {}
+        int32_t getReference() const override { return 1; }
+
+        void release() override
+        {
+            std::lock_guard lock(batch->mutex);
+            if(--batch->pendingTasks == 0) {
+                batch->released.notify_one();
+            }
+        }
+    };
+
+    /// Calls fun(first, last) for chunks of the range [0, count) on the
+    /// physics dispatcher's workers, each one picks the next pending chunk.
+    /// The calling thread participates.
+    template<typename Fun>
+    void forEachChunk(PxCpuDispatcher& dispatcher, size_t count, Fun fun)
+    {
+        ChunkBatch batch;
+        batch.count = count;
+        batch.chunkCount = (count + QUERY_CHUNK_SIZE - 1) / QUERY_CHUNK_SIZE;
+        batch.runChunk = [](void* f, size_t first, size_t last) { (*static_cast<Fun*>(f))(first, last); };
+        batch.fun = &fun;
+
+        const auto taskCount = std::min({batch.chunkCount > 0 ? batch.chunkCount - 1 : 0, (size_t)dispatcher.getWorkerCount(), MAX_QUERY_TASKS});
+        batch.pendingTasks = taskCount;
+
+        std::array<ChunkTask, MAX_QUERY_TASKS> tasks;
+        for(size_t i = 0; i < taskCount; ++i) {
+            tasks[i].batch = &batch;
+            dispatcher.submitTask(tasks[i]);
+        }
+
+        batch.work();
+
+        // Tasks refer to the batch until released, even if no chunk was left for them.
+        std::unique_lock lock(batch.mutex);
+        batch.released.wait(lock, [&] { return batch.pendingTasks == 0; });
+    }
+
+    QueryHit toQueryHit(const PxLocationHit& hit)
+    {
+        QueryHit result;
+        result.hit = true;
+        result.entity = static_cast<Entity*>(hit.actor->userData);
+        result.position = toVec3(hit.position);
+        result.normal = toVec3(hit.normal);
+        result.distance = hit.distance;
+        return result;
+    }
+
+} // namespace
+
+void PhysicsSystem::raycast(const Ray* rays, QueryHit* results, size_t count) const
+{
+    RAYGUN_ASSERT(!simulating());
+    RAYGUN_PROFILE_ZONE("Raycasts");
+
+    const auto& scene = *RG().scene().pxScene;
+
+    forEachChunk(*m_dispatcher, count, [&](size_t first, size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& ray = rays[i];
+
+            PxRaycastBuffer buffer;
+            if(scene.raycast(toVec3(ray.origin), toVec3(ray.direction), ray.maxDistance, buffer)) {
+                results[i] = toQueryHit(buffer.block);
+            }
+            else {
+                results[i] = {};
+            }
+        }
+    });
+}
+
+void PhysicsSystem::sweep(const Sweep* sweeps, QueryHit* results, size_t count) const
+{
+    RAYGUN_ASSERT(!simulating());
+    RAYGUN_PROFILE_ZONE("Sweeps");
+
+    const auto& scene = *RG().scene().pxScene;
+
+    forEachChunk(*m_dispatcher, count, [&](size_t first, size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& sweep = sweeps[i];
+
+            PxSweepBuffer buffer;
+            if(scene.sweep(sweep.geometry.any(), toTransform(sweep.pose), toVec3(sweep.direction), sweep.maxDistance, buffer)) {
+                results[i] = toQueryHit(buffer.block);
+            }
+            else {
+                results[i] = {};
+            }
+        }
+    });
+}
+
+void PhysicsSystem::overlap(const Overlap* overlaps, QueryHit* results, size_t count) const
+{
+    RAYGUN_ASSERT(!simulating());
+    RAYGUN_PROFILE_ZONE("Overlaps");
+
+    const auto& scene = *RG().scene().pxScene;
+
+    // Any overlapping actor is sufficient.
+    const PxQueryFilterData filterData(PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC | PxQueryFlag::eANY_HIT);
+
+    forEachChunk(*m_dispatcher, count, [&](size_t first, size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& overlap = overlaps[i];
+
+            PxOverlapBuffer buffer;
+            results[i] = {};
+            if(scene.overlap(overlap.geometry.any(), toTransform(overlap.pose), buffer, filterData) && buffer.hasBlock) {
+                results[i].hit = true;
+                results[i].entity = static_cast<Entity*>(buffer.block.actor->userData);
+            }
+        }
+    });
 }
 
 void PhysicsSystem::addTriggerEvent(const PxActor* trigger, TriggerCallback handler)
@@ -240,44 +708,101 @@ void PhysicsSystem::clearContactEvents()
 
 void PhysicsSystem::update(double timeDelta)
 {
+    beginSimulation(timeDelta);
+    endSimulation();
+}
+
+void PhysicsSystem::beginSimulation(double timeDelta)
+{
+    RAYGUN_ASSERT(!m_simulatingScene);
+
+    if(m_paused) return;
+
+    RAYGUN_PROFILE_ZONE("Begin Physics");
+
     auto& scene = RG().scene();
 
-    connectActorsToScene(scene);
+    scene.flushPhysicsActors();
 
-    simulate(*scene.pxScene, (float)timeDelta);
+    scene.pxScene->simulate((float)timeDelta);
+    m_simulatingScene = scene.pxScene.get();
+}
 
-    // Update transforms
-    scene.root->forEachEntity([&](Entity& entity) {
-        if(!entity.physicsActor) return;
+void PhysicsSystem::endSimulation()
+{
+    if(!m_simulatingScene) return;
 
-        if(auto rigidDynamic = dynamic_cast<PxRigidDynamic*>(entity.physicsActor.get())) {
-            auto transform = physics::toTransform(rigidDynamic->getGlobalPose(), entity.transform().scaling);
-            entity.setTransform(entity.parentTransform().inverse() * transform);
-        }
-    });
+    RAYGUN_PROFILE_ZONE("Physics");
+
+    {
+        RAYGUN_PROFILE_ZONE("Fetch Results");
+
+        // Time spent waiting shows how much of the simulation was not
+        // overlapped with other work.
+        const auto startTime = Clock::now();
+        m_simulatingScene->fetchResults(true);
+        const auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime);
+        RG().profiler().count(CounterID::PhysicsWaitUs, (uint32_t)waitTime.count());
+    }
+
+    m_simulatingScene = nullptr;
+
+    writeBack(RG().scene());
+
+    // Events are recorded during the simulation and dispatched here, so
+    // callbacks are free to modify the scene.
+    m_simCallback->dispatchEvents();
 }
 
-void PhysicsSystem::connectActorsToScene(Scene& scene)
+void PhysicsSystem::writeBack(Scene& scene)
 {
-    auto actors = getActors(*scene.pxScene);
+    // Update transforms of moving bodies only, sleeping ones are not reported
+    // as active.
+    RAYGUN_PROFILE_ZONE("Write Back");
+
+    PxU32 activeCount = 0;
+    const auto activeActors = scene.pxScene->getActiveActors(activeCount);
+
+    auto& arena = RG().frameArena();
+    utils::ArenaVector<std::pair<Entity*, Transform>> parentEntities(arena);
+    utils::ArenaVector<Entity*> entities(arena);
+    utils::ArenaVector<Transform> transforms(arena);
 
-    // Ensure all entities with physics actors are connected with the physics
-    // scene.
-    scene.root->forEachEntity([&](Entity& entity) {
-        if(!entity.physicsActor) return;
+    for(PxU32 i = 0; i < activeCount; ++i) {
+        const auto rigidDynamic = activeActors[i]->is<PxRigidDynamic>();
+        if(!rigidDynamic || !rigidDynamic->userData) continue;
 
-        const auto it = actors.find(entity.physicsActor.get());
-        if(it == actors.end()) {
-            scene.pxScene->addActor(*entity.physicsActor);
+        // Kinematic bodies are driven by their entity.
+        if(rigidDynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC) continue;
+
+        auto& entity = *static_cast<Entity*>(rigidDynamic->userData);
+        const auto transform = toTransform(rigidDynamic->getGlobalPose(), entity.transform().scaling);
+
+        if(entity.children().empty()) {
+            entities.push_back(&entity);
+            transforms.push_back(transform);
         }
         else {
-            actors.erase(it);
+            parentEntities.emplace_back(&entity, transform);
         }
-    });
+    }
+
+    // Children need the updated transform of their parents, so entities with
+    // children are updated first, top to bottom.
+    std::sort(parentEntities.begin(), parentEntities.end(), [](const auto& a, const auto& b) { return depth(*a.first) < depth(*b.first); });
+    for(auto& [entity, transform]: parentEntities) {
+        entity->setSimulatedTransform(entity->parentTransform().inverse() * transform);
+    }
+
+    utils::ArenaVector<Transform> parentInverses(arena);
+    parentInverses.reserve(entities.size());
+    for(const auto entity: entities) {
+        parentInverses.push_back(entity->parentTransform().inverse());
+    }
 
-    // Remove obsolete physics actors from physics scene.
-    for(const auto actor: actors) {
-        scene.pxScene->removeActor(*actor);
+    composeTransforms(parentInverses.data(), transforms.data(), transforms.data(), transforms.size());
+    for(size_t i = 0; i < entities.size(); ++i) {
+        entities[i]->setSimulatedTransform(transforms[i]);
     }
 }
 
@@ -24,6 +24,7 @@
 
 #include "raygun/entity.hpp"
 #include "raygun/physics/physics_error_callback.hpp"
+#include "raygun/physics/physics_query.hpp"
 #include "raygun/physics/physics_sim_callback.hpp"
 #include "raygun/physics/physics_utils.hpp"
 #include "raygun/render/mesh.hpp"
@@ -53,11 +54,18 @@ class PhysicsSystem {
     /// with the given callback. Removes the entity's attached model.
     void makeTrigger(Entity& entity, TriggerCallback callback, GeometryType geometryType);
 
+    /// Cooked collision meshes are cached on disk, keyed by a hash over the
+    /// mesh data and cooking parameters.
     UniqueTriangleMesh createTriangleMesh(const render::Mesh& mesh);
-
     UniqueConvexMesh createConvexMesh(const render::Mesh& mesh);
 
-    void simulate(physx::PxScene& scene, float timeDelta);
+    /// Same as above, but each mesh is cooked once and shared by all shapes
+    /// using it, only the mesh scale differs per shape.
+    physx::PxTriangleMesh* sharedTriangleMesh(const std::shared_ptr<render::Mesh>& mesh);
+    physx::PxConvexMesh* sharedConvexMesh(const std::shared_ptr<render::Mesh>& mesh);
+
+    /// Releases shared meshes no longer used by any shape.
+    void purgeSharedMeshes();
 
     physx::PxPhysics& physics() { return *m_physics; }
 
@@ -69,13 +77,44 @@ class PhysicsSystem {
     void addContactEvent(const physx::PxActor* trigger, ContactCallback handler);
     void clearContactEvents();
 
+    /// Contact points of the contact currently being reported, valid inside a
+    /// ContactCallback only.
+    const std::vector<ContactPoint>& contactPoints() const { return m_simCallback->contactPoints(); }
+
+    /// Drops buffered events of an actor about to be removed from its scene.
+    void dropEvents(const physx::PxActor& actor) { m_simCallback->dropEvents(&actor); }
+
+    /// Drops buffered events and callbacks of an actor about to be released.
+    void forgetActor(const physx::PxActor& actor) { m_simCallback->forgetActor(&actor); }
+
+    /// Runs a simulation step and writes the results back to the entities.
     void update(double timeDelta);
 
+    /// Split version of update. beginSimulation starts a simulation step,
+    /// which runs in the background until endSimulation waits for its results
+    /// and writes them back. Trigger and contact callbacks are invoked by
+    /// endSimulation as well. endSimulation does nothing if no simulation is
+    /// in flight.
+    void beginSimulation(double timeDelta);
+    void endSimulation();
+
+    bool simulating() const { return m_simulatingScene != nullptr; }
+
+    /// Batched scene queries against the current scene, distributed over
+    /// worker threads. results must hold count elements. Must not be called
+    /// while a simulation is in flight, i.e. between beginSimulation and
+    /// endSimulation.
+    void raycast(const Ray* rays, QueryHit* results, size_t count) const;
+    void sweep(const Sweep* sweeps, QueryHit* results, size_t count) const;
+    void overlap(const Overlap* overlaps, QueryHit* results, size_t count) const;
+
     void pause() { m_paused = true; }
     void unpause() { m_paused = false; }
 
   private:
-    static constexpr physx::PxU32 THREADS = 2;
+    static constexpr auto PVD_HOST = "localhost";
+    static constexpr int PVD_PORT = 5425;
+    static constexpr unsigned PVD_TIMEOUT_MS = 10;
 
     physx::PxDefaultAllocator m_allocator;
 
@@ -94,11 +133,32 @@ class PhysicsSystem {
 
     UniqueMaterial m_defaultMaterial;
 
+    fs::path m_meshCacheDir;
+
+    template<typename T>
+    struct SharedMesh {
+        std::weak_ptr<render::Mesh> mesh;
+        UniqueHandle<T> cooked;
+    };
+
+    /// Mesh and hash of the cooking parameters.
+    using SharedMeshKey = std::pair<const render::Mesh*, uint64_t>;
+
+    std::map<SharedMeshKey, SharedMesh<physx::PxTriangleMesh>> m_sharedTriangleMeshes;
+    std::map<SharedMeshKey, SharedMesh<physx::PxConvexMesh>> m_sharedConvexMeshes;
+
     std::unique_ptr<SimCallback> m_simCallback;
 
     bool m_paused = false;
 
-    void connectActorsToScene(Scene& scene);
+    physx::PxScene* m_simulatingScene = nullptr;
+
+    void writeBack(Scene& scene);
+
+    /// Returns cooked mesh data from the cache, or cooks it using the given
+    /// function and stores the result in the cache. Without readCache, an
+    /// existing cache entry is replaced.
+    std::vector<uint8_t> cookedMeshData(uint64_t key, string_view kind, const std::function<bool(physx::PxOutputStream&)>& cook, bool readCache = true);
 };
 
 using UniquePhysicsSystem = std::unique_ptr<PhysicsSystem>;
@@ -22,6 +22,9 @@
 
 #include "raygun/profiler.hpp"
 
+#include "raygun/assert.hpp"
+#include "raygun/config.hpp"
+#include "raygun/gpu/command_batch.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
 #include "raygun/render/render_system.hpp"
@@ -30,6 +33,33 @@
 
 namespace raygun {
 
+namespace {
+
+    constexpr std::array<const char*, (uint32_t)TimerID::Count> TIMER_NAMES = {
+        "Total",
+        "CPU",
+#define GPU_TIME(_name, _inchart, _color) #_name,
+#include "raygun/profiler.def"
+    };
+
+    /// Converts a timestamp of VulkanContext::hostTimeDomain to the timeline
+    /// of profiling::timestampNs.
+    uint64_t hostTimestampNs(uint64_t timestamp)
+    {
+#ifdef _WIN32
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        // Split like steady_clock does, to avoid overflow.
+        const auto ticksPerSecond = (uint64_t)frequency.QuadPart;
+        return timestamp / ticksPerSecond * 1000000000 + timestamp % ticksPerSecond * 1000000000 / ticksPerSecond;
+#else
+        return timestamp;
+#endif
+    }
+
+} // namespace
+
 Profiler::Profiler() : vc(RG().vc())
 {
     vk::QueryPoolCreateInfo timestampQPCI;
@@ -39,9 +69,215 @@ Profiler::Profiler() : vc(RG().vc())
 
     timestampValidBits = vc.physicalDevice.getQueueFamilyProperties()[0].timestampValidBits;
 
+    timerStats[(uint32_t)TimerID::Total].setBudget(RG().config().frameBudgetMs);
+    timerStats[(uint32_t)TimerID::CPU].setBudget(RG().config().frameBudgetMs);
+
+    hitchSnapshots.reserve(MAX_HITCHES);
+
+    if(RG().config().traceOnStartup) {
+        captureTrace((uint32_t)RG().config().traceFrames);
+    }
+
     RAYGUN_INFO("Profiler initialized");
 }
 
+Profiler::~Profiler()
+{
+    if(traceCapture) {
+        finishTrace();
+    }
+
+    for(uint32_t i = 0; i < (uint32_t)TimerID::Count; ++i) {
+        const auto& stats = timerStats[i];
+        if(stats.count() == 0) continue;
+
+        RAYGUN_INFO("{}: p50 {:.2f} ms | p99 {:.2f} ms | max {:.2f} ms | stddev {:.2f} ms | over budget {}", TIMER_NAMES[i], stats.percentile(0.5),
+                    stats.percentile(0.99), stats.max(), stats.stddev(), stats.overBudget());
+    }
+
+    dumpStatistics(configDirectory() / "profiler_stats.json");
+}
+
+const char* Profiler::timerName(TimerID id)
+{
+    return TIMER_NAMES[(uint32_t)id];
+}
+
+void Profiler::resetStatistics()
+{
+    for(auto& stats: timerStats) {
+        stats.reset();
+    }
+
+    hitchSnapshots.clear();
+    hitchCount = 0;
+}
+
+json Profiler::statistics() const
+{
+    json timers;
+    for(uint32_t i = 0; i < (uint32_t)TimerID::Count; ++i) {
+        timers[TIMER_NAMES[i]] = timerStats[i].toJson();
+    }
+
+    auto hitches = json::array();
+    for(const auto& hitch: hitchSnapshots) {
+        hitches.push_back({{"frame", hitch.frameIndex}, {"frameMs", hitch.frameMs}});
+    }
+
+    return {{"frames", frameIndex}, {"timers", std::move(timers)}, {"hitchCount", hitchCount}, {"hitches", std::move(hitches)}};
+}
+
+void Profiler::dumpStatistics(const fs::path& path) const
+{
+    {
+        std::ofstream out(path);
+        if(!out) {
+            RAYGUN_ERROR("Unable to write profiler statistics: {}", path);
+            return;
+        }
+
+        out << statistics().dump(2);
+    }
+
+    for(const auto& hitch: hitchSnapshots) {
+        if(hitch.frames.empty()) continue;
+
+        const auto tracePath = path.parent_path() / "traces" / fmt::format("hitch_{}.json", hitch.frameIndex);
+
+        profiling::TraceCapture capture(tracePath, 0, 0.0, hitch.frames.front().startNs);
+        for(const auto& frame: hitch.frames) {
+            capture.addFrame(frame.index, frame.startNs, frame.endNs);
+            capture.addZones(frame.threads);
+        }
+        capture.write();
+    }
+
+    RAYGUN_INFO("Profiler statistics written to {}", path);
+}
+
+void Profiler::recordHitch(double frameMs)
+{
+    hitchCount++;
+
+    // Only the slowest frames are kept.
+    auto slot = hitchSnapshots.end();
+    if(hitchSnapshots.size() < MAX_HITCHES) {
+        slot = hitchSnapshots.emplace(slot);
+    }
+    else {
+        slot = std::min_element(hitchSnapshots.begin(), hitchSnapshots.end(), [](const auto& a, const auto& b) { return a.frameMs < b.frameMs; });
+        if(slot->frameMs >= frameMs) return;
+    }
+
+    slot->frameIndex = frameIndex;
+    slot->frameMs = frameMs;
+
+    // Frames are assigned in place, so a replaced snapshot reuses the storage
+    // of the previous one.
+    size_t count = 0;
+    for(uint32_t i = 1; i <= HITCH_HISTORY_FRAMES; ++i) {
+        const auto& frame = recentFrames[(frameIndex + i) % HITCH_HISTORY_FRAMES];
+        if(frame.endNs == 0 || frame.index > frameIndex) continue;
+
+        if(count < slot->frames.size()) {
+            slot->frames[count] = frame;
+        }
+        else {
+            slot->frames.push_back(frame);
+        }
+        count++;
+    }
+    slot->frames.resize(count);
+
+    RAYGUN_WARN("Hitch in frame {}: {:.2f} ms", frameIndex, frameMs);
+}
+
+void Profiler::captureTrace(uint32_t frames, double seconds, fs::path path)
+{
+    if(traceCapture) {
+        RAYGUN_WARN("Trace capture already in progress");
+        return;
+    }
+
+    if(path.empty()) {
+        const auto now = std::time(nullptr);
+        std::array<char, 32> name;
+        std::strftime(name.data(), name.size(), "trace_%Y%m%d_%H%M%S.json", std::localtime(&now));
+
+        path = configDirectory() / "traces" / name.data();
+    }
+
+    calibrateGpuClock();
+
+    traceCapture = std::make_unique<profiling::TraceCapture>(std::move(path), frames, seconds);
+
+    RAYGUN_INFO("Capturing trace to {}", traceCapture->path());
+}
+
+void Profiler::finishTrace()
+{
+    traceCapture->write();
+    traceCapture.reset();
+}
+
+void Profiler::calibrateGpuClock()
+{
+    const auto toNs = [&](uint64_t ticks) {
+        return (int64_t)((double)glm::bitfieldExtract<uint64_t>(ticks, 0, timestampValidBits) * vc.physicalDeviceProperties.limits.timestampPeriod);
+    };
+
+    uint64_t cpuNs;
+    uint64_t uncertaintyNs;
+    uint64_t gpuTicks = 0;
+
+    if(vc.calibratedTimestamps) {
+        // Device and host timestamps are sampled together, the driver reports
+        // how far apart they may be.
+        std::array<vk::CalibratedTimestampInfoEXT, 2> infos;
+        infos[0].setTimeDomain(vk::TimeDomainEXT::eDevice);
+        infos[1].setTimeDomain(VulkanContext::hostTimeDomain);
+
+        std::array<uint64_t, 2> timestamps = {};
+        uint64_t maxDeviation = 0;
+
+        const auto result = vc.device->getCalibratedTimestampsEXT((uint32_t)infos.size(), infos.data(), timestamps.data(), &maxDeviation);
+        RAYGUN_ASSERT(result == vk::Result::eSuccess);
+
+        gpuTicks = timestamps[0];
+        cpuNs = hostTimestampNs(timestamps[1]);
+        uncertaintyNs = maxDeviation;
+    }
+    else {
+        // Without the extension, the timestamp of an otherwise empty submission
+        // is used. It lands somewhere between submit and the wait returning.
+        vk::QueryPoolCreateInfo queryPoolInfo;
+        queryPoolInfo.setQueryType(vk::QueryType::eTimestamp);
+        queryPoolInfo.setQueryCount(1);
+        const auto queryPool = vc.device->createQueryPoolUnique(queryPoolInfo);
+
+        gpu::CommandBatch batch(*vc.graphicsQueue, "Profiler Calibration");
+        batch.commandBuffer().resetQueryPool(*queryPool, 0, 1);
+        batch.commandBuffer().writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *queryPool, 0);
+
+        const auto cpuBeforeNs = profiling::timestampNs();
+        batch.submit().wait();
+        const auto cpuAfterNs = profiling::timestampNs();
+
+        const auto result = vc.device->getQueryPoolResults(*queryPool, 0, 1, sizeof(gpuTicks), &gpuTicks, sizeof(gpuTicks),
+                                                           vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+        RAYGUN_ASSERT(result == vk::Result::eSuccess);
+
+        cpuNs = cpuBeforeNs + (cpuAfterNs - cpuBeforeNs) / 2;
+        uncertaintyNs = cpuAfterNs - cpuBeforeNs;
+    }
+
+    gpuClockOffsetNs = (int64_t)cpuNs - toNs(gpuTicks);
+
+    RAYGUN_DEBUG("GPU clock calibrated ({}), uncertainty {:.3f} ms", vc.calibratedTimestamps ? "calibrated timestamps" : "submission",
+                 (double)uncertaintyNs / (1000.0 * 1000.0));
+}
+
 uint64_t Profiler::getTimestamp(TimestampQueryID id) const
 {
     return timestampQueryResults[(uint32_t)id];
@@ -67,53 +303,108 @@ void Profiler::startFrame()
 {
     if(frameStartTime == Clock::time_point::min()) {
         frameStartTime = Clock::now();
+        frameStartNs = profiling::timestampNs();
         return;
     }
 
-    // Get GPU times from device
-    {
-        const auto result =
-            vc.device->getQueryPoolResults(*timestampQueryPool, prevQueryFrame() * MAX_TIMESTAMP_QUERIES, MAX_TIMESTAMP_QUERIES, timestampQueryResults.size(),
-                                           timestampQueryResults.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    // Store counters of the previous frame
+#define COUNTER(_name) _name##Counts[curStatFrame] = (float)counters[(uint32_t)CounterID::_name];
+#include "raygun/profiler.def"
+    counters = {};
 
-        if(result != vk::Result::eSuccess && result != vk::Result::eNotReady) {
-            RAYGUN_INFO("Unable to get query pool results");
-            return;
-        }
+    profiling::collect(zoneThreads);
+    buildZoneTrees();
+
+    const auto frameEndNs = profiling::timestampNs();
+
+    if(traceCapture) {
+        traceCapture->addFrame(frameIndex, frameStartNs, frameEndNs);
+        traceCapture->addZones(zoneThreads);
+
+#define COUNTER(_name) traceCapture->addCounter(#_name, frameStartNs, _name##Counts[curStatFrame]);
+#include "raygun/profiler.def"
     }
 
-    // Transform GPU times from from ticks (plus some potential invalid bits) to valid time units
-    std::transform(timestampQueryResults.cbegin(), timestampQueryResults.cend(), timestampQueryResults.begin(), [&](uint64_t ts) {
-        return glm::bitfieldExtract<std::uint64_t>(ts, 0, timestampValidBits) / (uint64_t)vc.physicalDeviceProperties.limits.timestampPeriod;
-    });
+    // Get GPU times from device
+    const auto result =
+        vc.device->getQueryPoolResults(*timestampQueryPool, prevQueryFrame() * MAX_TIMESTAMP_QUERIES, MAX_TIMESTAMP_QUERIES, timestampQueryResults.size(),
+                                       timestampQueryResults.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+    if(result == vk::Result::eSuccess || result == vk::Result::eNotReady) {
+        // Transform GPU times from ticks (plus some potential invalid bits) to nanoseconds
+        std::transform(timestampQueryResults.cbegin(), timestampQueryResults.cend(), timestampQueryResults.begin(), [&](uint64_t ts) {
+            return (uint64_t)((double)glm::bitfieldExtract<std::uint64_t>(ts, 0, timestampValidBits) * vc.physicalDeviceProperties.limits.timestampPeriod);
+        });
 
-    // Store current GPU times in statistics array
+        // Store current GPU times in statistics array
 #define GPU_TIME(_name, _inchart, _color) _name##Times[curStatFrame] = (float)getTimeRangeMS(TimestampQueryID::_name##Start, TimestampQueryID::_name##End);
 #include "raygun/profiler.def"
 
+        // Results that are not ready yet may be stale, only complete ones are traced.
+        if(result == vk::Result::eSuccess) {
+#define GPU_TIME(_name, _inchart, _color) timerStats[(uint32_t)TimerID::_name].add(_name##Times[curStatFrame]);
+#include "raygun/profiler.def"
+        }
+
+        if(traceCapture && result == vk::Result::eSuccess) {
+#define GPU_TIME(_name, _inchart, _color) \
+    traceCapture->addGpuRange(#_name, getTimestamp(TimestampQueryID::_name##Start) + gpuClockOffsetNs, \
+                              getTimestamp(TimestampQueryID::_name##End) + gpuClockOffsetNs);
+#include "raygun/profiler.def"
+        }
+    }
+    else {
+        RAYGUN_INFO("Unable to get query pool results");
+    }
+
     float frameTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frameStartTime).count() / 1000.f;
     totalTimes[curStatFrame] = frameTimeMs;
+    timerStats[(uint32_t)TimerID::Total].add(frameTimeMs);
+
+    // Zones of recent frames are kept around for hitch snapshots.
+    {
+        auto& frame = recentFrames[frameIndex % HITCH_HISTORY_FRAMES];
+        frame.index = frameIndex;
+        frame.startNs = frameStartNs;
+        frame.endNs = frameEndNs;
+        frame.threads = zoneThreads;
+    }
+
+    const auto hitchThreshold = RG().config().hitchThresholdMs;
+    if(hitchThreshold > 0.0 && frameTimeMs > hitchThreshold) {
+        recordHitch(frameTimeMs);
+    }
+
+    if(traceCapture && traceCapture->done()) {
+        finishTrace();
+    }
 
     incFrame();
+    frameIndex++;
     frameStartTime = Clock::now();
+    frameStartNs = frameEndNs;
 }
 
 void Profiler::endFrame()
 {
     float frameTimeMs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frameStartTime).count() / 1000.f;
     cpuTimes[curStatFrame] = frameTimeMs;
+    timerStats[(uint32_t)TimerID::CPU].add(frameTimeMs);
 }
 
 void Profiler::doUI() const
 {
     ImGui::Begin("Profiling");
 
-    string gpuTTexts = "GPU times";
-    string gpuTMeans = "     mean";
+    // Formatted into the frame arena to avoid heap allocations every frame.
+    auto& arena = RG().frameArena();
+
+    utils::ArenaString gpuTTexts("GPU times", arena);
+    utils::ArenaString gpuTMeans("     mean", arena);
 
 #define GPU_TIME(_name, _inchart, _color) \
-    gpuTTexts += fmt::format(" | {}: {:5.2f}", #_name, _name##Times[prevStatFrame()]); \
-    gpuTMeans += fmt::format(" | {}: {:5.2f}", #_name, utils::mean(_name##Times));
+    fmt::format_to(std::back_inserter(gpuTTexts), " | {}: {:5.2f}", #_name, _name##Times[prevStatFrame()]); \
+    fmt::format_to(std::back_inserter(gpuTMeans), " | {}: {:5.2f}", #_name, utils::mean(_name##Times));
 #include "raygun/profiler.def"
 
     ImGui::Text("CPU times | %s: %5.2f | %s: %5.2f", "CPU", cpuTimes[prevStatFrame()], "Total", totalTimes[prevStatFrame()]);
@@ -122,14 +413,54 @@ void Profiler::doUI() const
     ImGui::Text("%s", gpuTTexts.c_str());
     ImGui::Text("%s", gpuTMeans.c_str());
 
+    utils::ArenaString counterTexts(" Counters", arena);
+    utils::ArenaString counterMeans("     mean", arena);
+
+#define COUNTER(_name) \
+    fmt::format_to(std::back_inserter(counterTexts), " | {}: {:5.0f}", #_name, _name##Counts[prevStatFrame()]); \
+    fmt::format_to(std::back_inserter(counterMeans), " | {}: {:5.1f}", #_name, utils::mean(_name##Counts));
+#include "raygun/profiler.def"
+
+    ImGui::Text("%s", counterTexts.c_str());
+    ImGui::Text("%s", counterMeans.c_str());
+
+    if(ImGui::BeginTable("Timer Statistics", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+        for(auto column: {"Timer", "p50", "p90", "p99", "p99.9", "max", "stddev", "over budget"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+
+        for(uint32_t i = 0; i < (uint32_t)TimerID::Count; ++i) {
+            const auto& stats = timerStats[i];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", TIMER_NAMES[i]);
+            for(auto fraction: {0.5, 0.9, 0.99, 0.999}) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%6.2f", stats.percentile(fraction));
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%6.2f", stats.max());
+            ImGui::TableNextColumn();
+            ImGui::Text("%6.2f", stats.stddev());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)stats.overBudget());
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::Text("Hitches: %llu", (unsigned long long)hitchCount);
+
     float smoothedMax = 0.f;
     for(size_t i = 1; i < STATISTIC_FRAMES - 1; ++i) {
         smoothedMax = std::max(smoothedMax, std::min(totalTimes[i - 1], totalTimes[i]));
     }
 
-    std::vector<const char*> names{"Total time", "CPU time"};
-    std::vector<ImColor> colors{ImColor(0.9f, 0.9f, 0.9f), ImColor(0.6f, 0.6f, 0.6f)};
-    std::vector<const void*> datas{totalTimes.data(), cpuTimes.data()};
+    utils::ArenaVector<const char*> names({"Total time", "CPU time"}, arena);
+    utils::ArenaVector<ImColor> colors({ImColor(0.9f, 0.9f, 0.9f), ImColor(0.6f, 0.6f, 0.6f)}, arena);
+    utils::ArenaVector<const void*> datas({totalTimes.data(), cpuTimes.data()}, arena);
 
 #define GPU_TIME(_name, _inchart, _color) \
     if constexpr(_inchart) { \
@@ -143,9 +474,111 @@ void Profiler::doUI() const
         "Frametimes", (int)names.size(), names.data(), colors.data(),
         [&](const void* data, int idx) { return static_cast<const float*>(data)[(prevStatFrame() + idx) % STATISTIC_FRAMES]; }, datas.data(), STATISTIC_FRAMES,
         0, smoothedMax + 1, ImVec2(STATISTIC_FRAMES, 200));
+
+    auto zonesEnabled = profiling::enabled();
+    if(ImGui::Checkbox("CPU zones", &zonesEnabled)) {
+        profiling::setEnabled(zonesEnabled);
+    }
+
+    for(const auto& tree: zoneTrees) {
+        if(ImGui::TreeNodeEx(zoneThreads[tree.thread].threadName.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+            const auto& root = zoneNodes[tree.root];
+            for(auto i = root.childBegin; i < root.childBegin + root.childCount; ++i) {
+                zoneTreeUI(zoneChildren[i]);
+            }
+            ImGui::TreePop();
+        }
+    }
+
     ImGui::End();
 }
 
+void Profiler::zoneTreeUI(uint32_t index) const
+{
+    const auto& node = zoneNodes[index];
+
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_DefaultOpen;
+    if(node.childCount == 0) {
+        flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+    }
+
+    const auto open = ImGui::TreeNodeEx((void*)(uintptr_t)index, flags, "%s: %.3f ms (%u)", node.name, node.totalNs / (1000.0 * 1000.0), node.calls);
+    if(open && node.childCount > 0) {
+        for(auto i = node.childBegin; i < node.childBegin + node.childCount; ++i) {
+            zoneTreeUI(zoneChildren[i]);
+        }
+        ImGui::TreePop();
+    }
+}
+
+void Profiler::buildZoneTrees()
+{
+    zoneTrees.clear();
+    zoneNodes.clear();
+    zoneChildren.clear();
+
+    for(uint32_t t = 0; t < (uint32_t)zoneThreads.size(); ++t) {
+        auto& thread = zoneThreads[t];
+        if(thread.events.empty()) continue;
+
+        if(thread.droppedEvents > 0) {
+            RAYGUN_WARN("{}: dropped {} CPU zones", thread.threadName, thread.droppedEvents);
+        }
+
+        // Zones are recorded when they end, so children precede their parents.
+        std::sort(thread.events.begin(), thread.events.end(), [](const auto& a, const auto& b) {
+            return a.startNs < b.startNs || (a.startNs == b.startNs && a.depth < b.depth);
+        });
+
+        const auto root = (uint32_t)zoneNodes.size();
+        zoneTrees.push_back({t, root});
+        zoneNodes.emplace_back();
+
+        zonePath.clear();
+        zonePath.push_back(root);
+
+        for(const auto& event: thread.events) {
+            // Parents of zones still open in the previous frame are missing, attach those zones to the deepest known node.
+            zonePath.resize(std::min<size_t>(zonePath.size(), event.depth + 1));
+
+            const auto parent = zonePath.back();
+
+            auto index = zoneNodes[parent].firstChild;
+            while(index != NO_ZONE_NODE && std::strcmp(zoneNodes[index].name, event.name) != 0) {
+                index = zoneNodes[index].nextSibling;
+            }
+
+            if(index == NO_ZONE_NODE) {
+                index = (uint32_t)zoneNodes.size();
+                zoneNodes.emplace_back().name = event.name;
+
+                auto& parentNode = zoneNodes[parent];
+                if(parentNode.lastChild == NO_ZONE_NODE) {
+                    parentNode.firstChild = index;
+                }
+                else {
+                    zoneNodes[parentNode.lastChild].nextSibling = index;
+                }
+                parentNode.lastChild = index;
+                parentNode.childCount++;
+            }
+
+            zoneNodes[index].totalNs += event.endNs - event.startNs;
+            zoneNodes[index].calls++;
+
+            zonePath.push_back(index);
+        }
+    }
+
+    // Children of each node are stored as one contiguous range.
+    for(auto& node: zoneNodes) {
+        node.childBegin = (uint32_t)zoneChildren.size();
+        for(auto child = node.firstChild; child != NO_ZONE_NODE; child = zoneNodes[child].nextSibling) {
+            zoneChildren.push_back(child);
+        }
+    }
+}
+
 uint32_t Profiler::prevQueryFrame() const
 {
     return (int)curQueryFrame - 1 < 0 ? QUERY_BUFFER_FRAMES - 1 : curQueryFrame - 1;
@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include "raygun/profiler_stats.hpp"
+#include "raygun/profiler_trace.hpp"
+#include "raygun/profiler_zones.hpp"
 #include "raygun/vulkan_context.hpp"
 
 namespace raygun {
@@ -33,9 +36,26 @@ enum class TimestampQueryID : uint32_t {
     Count,
 };
 
+enum class CounterID : uint32_t {
+
+#define COUNTER(_name) _name,
+#include "raygun/profiler.def"
+    Count,
+};
+
+enum class TimerID : uint32_t {
+    Total,
+    CPU,
+
+#define GPU_TIME(_name, _inchart, _color) _name,
+#include "raygun/profiler.def"
+    Count,
+};
+
 class Profiler {
   public:
     Profiler();
+    ~Profiler();
 
     void writeTimestamp(vk::CommandBuffer& cmdBuffer, TimestampQueryID id, vk::PipelineStageFlagBits pipelineStage = vk::PipelineStageFlagBits::eAllCommands);
     double getTimeRangeMS(TimestampQueryID begin, TimestampQueryID end) const;
@@ -44,11 +64,39 @@ class Profiler {
     // containing the first executed commands.
     void resetVulkanQueries(vk::CommandBuffer& cmdBuffer);
 
+    /// Adds to a per-frame counter.
+    void count(CounterID id, uint32_t amount = 1) { counters[(uint32_t)id] += amount; }
+
     void startFrame();
     void endFrame();
 
     void doUI() const;
 
+    /// CPU zones recorded during the previous frame, per thread.
+    const std::vector<profiling::ThreadZones>& frameZones() const { return zoneThreads; }
+
+    /// Records CPU zones, GPU times, frame markers and counters of the
+    /// following frames into a Chrome trace. Ends after the given number of
+    /// frames or seconds, whichever comes first (0 = no limit). Without a
+    /// path the trace is written to the traces directory in the config
+    /// directory.
+    void captureTrace(uint32_t frames, double seconds = 0.0, fs::path path = {});
+    bool capturingTrace() const { return traceCapture != nullptr; }
+
+    /// Statistics over all frames since startup or the last reset.
+    const profiling::TimerStats& stats(TimerID id) const { return timerStats[(uint32_t)id]; }
+    static const char* timerName(TimerID id);
+    void resetStatistics();
+
+    /// Frames exceeding the hitch threshold, the slowest ones are kept.
+    const std::vector<profiling::Hitch>& hitches() const { return hitchSnapshots; }
+
+    json statistics() const;
+
+    /// Writes statistics to the given file, and the zones of each hitch as
+    /// Chrome trace next to it.
+    void dumpStatistics(const fs::path& path) const;
+
   private:
     static constexpr uint32_t QUERY_BUFFER_FRAMES = 8;
     static constexpr uint32_t MAX_TIMESTAMP_QUERIES = (uint32_t)TimestampQueryID::Count;
@@ -56,6 +104,10 @@ class Profiler {
 
     Clock::time_point frameStartTime = Clock::time_point::min();
 
+    // On the CPU zone timeline.
+    uint64_t frameStartNs = 0;
+    uint64_t frameIndex = 0;
+
     uint32_t curQueryFrame = 0;
     uint32_t prevQueryFrame() const;
     void incFrame();
@@ -66,15 +118,72 @@ class Profiler {
     std::array<uint64_t, MAX_TIMESTAMP_QUERIES* QUERY_BUFFER_FRAMES> timestampQueryResults = {};
     uint32_t timestampValidBits;
 
+    /// Maps GPU timestamps (in ns) onto the CPU zone timeline.
+    int64_t gpuClockOffsetNs = 0;
+    void calibrateGpuClock();
+
     std::array<float, STATISTIC_FRAMES> cpuTimes = {};
     std::array<float, STATISTIC_FRAMES> totalTimes = {};
 
 #define GPU_TIME(_name, _inchart, _color) std::array<float, STATISTIC_FRAMES> _name##Times = {};
+#include "raygun/profiler.def"
+
+    std::array<uint32_t, (uint32_t)CounterID::Count> counters = {};
+
+#define COUNTER(_name) std::array<float, STATISTIC_FRAMES> _name##Counts = {};
 #include "raygun/profiler.def"
 
     uint32_t curStatFrame = 0;
     uint32_t prevStatFrame() const;
 
+    static constexpr uint32_t NO_ZONE_NODE = ~0u;
+
+    struct ZoneNode {
+        const char* name = "";
+        uint64_t totalNs = 0;
+        uint32_t calls = 0;
+
+        /// Range in zoneChildren.
+        uint32_t childBegin = 0;
+        uint32_t childCount = 0;
+
+        // Sibling list, only used while building.
+        uint32_t firstChild = NO_ZONE_NODE;
+        uint32_t lastChild = NO_ZONE_NODE;
+        uint32_t nextSibling = NO_ZONE_NODE;
+    };
+
+    /// Zones of one thread in zoneThreads merged by call path.
+    struct ZoneTree {
+        uint32_t thread;
+        uint32_t root;
+    };
+
+    std::vector<profiling::ThreadZones> zoneThreads;
+
+    // Rebuilt every frame, the storage is reused.
+    std::vector<ZoneTree> zoneTrees;
+    std::vector<ZoneNode> zoneNodes;
+    std::vector<uint32_t> zoneChildren;
+    std::vector<uint32_t> zonePath;
+
+    void buildZoneTrees();
+    void zoneTreeUI(uint32_t index) const;
+
+    std::unique_ptr<profiling::TraceCapture> traceCapture;
+    void finishTrace();
+
+    static constexpr uint32_t HITCH_HISTORY_FRAMES = 8;
+    static constexpr uint32_t MAX_HITCHES = 32;
+
+    std::array<profiling::TimerStats, (uint32_t)TimerID::Count> timerStats;
+
+    std::array<profiling::FrameZones, HITCH_HISTORY_FRAMES> recentFrames;
+    std::vector<profiling::Hitch> hitchSnapshots;
+    uint64_t hitchCount = 0;
+
+    void recordHitch(double frameMs);
+
     VulkanContext& vc;
 };
 
@@ -0,0 +1,128 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/profiler_stats.hpp"
+
+namespace raygun::profiling {
+
+void TimerStats::add(double ms)
+{
+    const auto us = (uint64_t)std::max(0.0, ms * 1000.0);
+    m_buckets[bucketIndex(us)]++;
+
+    m_count++;
+    if(m_budget > 0.0 && ms > m_budget) {
+        m_overBudget++;
+    }
+
+    m_min = std::min(m_min, ms);
+    m_max = std::max(m_max, ms);
+
+    const auto delta = ms - m_mean;
+    m_mean += delta / (double)m_count;
+    m_m2 += delta * (ms - m_mean);
+}
+
+void TimerStats::reset()
+{
+    const auto budget = m_budget;
+    *this = {};
+    m_budget = budget;
+}
+
+double TimerStats::stddev() const
+{
+    return m_count > 1 ? std::sqrt(m_m2 / (double)(m_count - 1)) : 0.0;
+}
+
+double TimerStats::percentile(double fraction) const
+{
+    if(m_count == 0) return 0.0;
+
+    const auto rank = (uint64_t)std::ceil(std::clamp(fraction, 0.0, 1.0) * (double)m_count);
+
+    uint64_t seen = 0;
+    for(uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i];
+        if(seen >= std::max<uint64_t>(rank, 1)) {
+            // Exact extremes are known, bucket midpoints are only estimates.
+            return std::clamp(bucketValue(i) / 1000.0, m_min, m_max);
+        }
+    }
+
+    return m_max;
+}
+
+json TimerStats::toJson() const
+{
+    return {
+        {"count", m_count},
+        {"min", min()},
+        {"max", max()},
+        {"mean", mean()},
+        {"stddev", stddev()},
+        {"p50", percentile(0.5)},
+        {"p90", percentile(0.9)},
+        {"p99", percentile(0.99)},
+        {"p99.9", percentile(0.999)},
+        {"budget", m_budget},
+        {"overBudget", m_overBudget},
+    };
+}
+
+uint32_t TimerStats::bucketIndex(uint64_t us)
+{
+    us = std::min<uint64_t>(us, (uint64_t(1) << MAX_VALUE_BITS) - 1);
+
+    if(us < SUB_BUCKETS) {
+        return (uint32_t)us;
+    }
+
+    uint32_t msb = SUB_BUCKET_BITS;
+    while(us >> (msb + 1)) {
+        msb++;
+    }
+
+    // The bits following the most significant one select the linear sub bucket.
+    const auto shift = msb - SUB_BUCKET_BITS;
+    const auto subBucket = (uint32_t)(us >> shift) & (SUB_BUCKETS - 1);
+
+    return (shift + 1) * SUB_BUCKETS + subBucket;
+}
+
+double TimerStats::bucketValue(uint32_t index)
+{
+    const auto group = index / SUB_BUCKETS;
+    const auto subBucket = index % SUB_BUCKETS;
+
+    if(group == 0) {
+        return (double)subBucket;
+    }
+
+    const auto width = (double)(uint64_t(1) << (group - 1));
+    const auto lower = (double)(SUB_BUCKETS + subBucket) * width;
+
+    return lower + 0.5 * (width - 1.0);
+}
+
+} // namespace raygun::profiling
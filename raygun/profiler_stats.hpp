@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/profiler_zones.hpp"
+
+namespace raygun::profiling {
+
+/// Streaming statistics of a timer in milliseconds. Percentiles are taken
+/// from a log-linear histogram over microseconds, which bounds their
+/// relative error by 1 / SUB_BUCKETS.
+class TimerStats {
+  public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    // Up to 2^36 us (~19 hours), larger values end up in the last bucket.
+    static constexpr uint32_t MAX_VALUE_BITS = 36;
+    static constexpr uint32_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void add(double ms);
+    void reset();
+
+    /// A budget of 0 disables counting values over budget.
+    void setBudget(double ms) { m_budget = ms; }
+    double budget() const { return m_budget; }
+
+    uint64_t count() const { return m_count; }
+    uint64_t overBudget() const { return m_overBudget; }
+
+    double min() const { return m_count ? m_min : 0.0; }
+    double max() const { return m_count ? m_max : 0.0; }
+    double mean() const { return m_mean; }
+    double stddev() const;
+
+    /// Value below which the given fraction (0..1) of all values lies.
+    double percentile(double fraction) const;
+
+    json toJson() const;
+
+  private:
+    static uint32_t bucketIndex(uint64_t us);
+    static double bucketValue(uint32_t index);
+
+    std::array<uint32_t, BUCKET_COUNT> m_buckets = {};
+
+    uint64_t m_count = 0;
+    uint64_t m_overBudget = 0;
+
+    double m_budget = 0.0;
+
+    double m_min = std::numeric_limits<double>::max();
+    double m_max = 0.0;
+
+    // Welford's running mean and sum of squared differences.
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+};
+
+/// Zones of all threads recorded during one frame.
+struct FrameZones {
+    uint64_t index = 0;
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    std::vector<ThreadZones> threads;
+};
+
+/// Snapshot of the frames leading up to (and including) a hitch.
+struct Hitch {
+    uint64_t frameIndex = 0;
+    double frameMs = 0.0;
+
+    /// Oldest first.
+    std::vector<FrameZones> frames;
+};
+
+} // namespace raygun::profiling
@@ -0,0 +1,165 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/profiler_trace.hpp"
+
+#include "raygun/logging.hpp"
+
+namespace raygun::profiling {
+
+namespace {
+
+    constexpr uint32_t CPU_PID = 1;
+    constexpr uint32_t GPU_PID = 2;
+
+    // Thread 0 of the CPU process holds frame markers, recorded threads follow.
+    constexpr uint32_t FRAMES_TID = 0;
+
+    json metadata(const char* type, uint32_t pid, uint32_t tid, string_view name)
+    {
+        return {{"ph", "M"}, {"name", type}, {"pid", pid}, {"tid", tid}, {"args", {{"name", name}}}};
+    }
+
+} // namespace
+
+TraceCapture::TraceCapture(fs::path path, uint32_t maxFrames, double maxSeconds, uint64_t startNs)
+    : m_path(std::move(path))
+    , m_maxFrames(maxFrames)
+    , m_maxSeconds(maxSeconds)
+    , m_startNs(startNs)
+{
+}
+
+void TraceCapture::addZones(const std::vector<ThreadZones>& threads)
+{
+    for(const auto& thread: threads) {
+        if(thread.events.empty()) continue;
+
+        m_threadNames[thread.threadIndex] = thread.threadName;
+
+        for(const auto& event: thread.events) {
+            // Zones opened before the capture started are cut off.
+            if(event.startNs < m_startNs) continue;
+
+            m_zones.push_back({thread.threadIndex, event});
+        }
+    }
+}
+
+void TraceCapture::addGpuRange(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    if(startNs < m_startNs || endNs <= startNs) return;
+
+    m_gpuRanges.push_back({name, startNs, endNs});
+}
+
+void TraceCapture::addFrame(uint64_t index, uint64_t startNs, uint64_t endNs)
+{
+    m_frames.push_back({index, std::max(startNs, m_startNs), endNs});
+}
+
+void TraceCapture::addCounter(const char* name, uint64_t timeNs, double value)
+{
+    // Counters of the frame the capture started in are moved to its start, like the frame itself.
+    m_counters.push_back({name, std::max(timeNs, m_startNs), value});
+}
+
+bool TraceCapture::done() const
+{
+    if(m_maxFrames > 0 && m_frames.size() >= m_maxFrames) {
+        return true;
+    }
+
+    if(m_maxSeconds > 0.0 && (double)(timestampNs() - m_startNs) / 1e9 >= m_maxSeconds) {
+        return true;
+    }
+
+    return false;
+}
+
+void TraceCapture::write() const
+{
+    const auto startTime = Clock::now();
+
+    // Trace event timestamps are in microseconds, relative to the capture start.
+    const auto toUs = [&](uint64_t ns) { return (double)(ns - m_startNs) / 1000.0; };
+
+    auto events = json::array();
+
+    events.push_back(metadata("process_name", CPU_PID, FRAMES_TID, "CPU"));
+    events.push_back(metadata("process_name", GPU_PID, 0, "GPU"));
+    events.push_back(metadata("thread_name", CPU_PID, FRAMES_TID, "Frames"));
+    events.push_back(metadata("thread_name", GPU_PID, 0, "Graphics Queue"));
+
+    for(const auto& [index, name]: m_threadNames) {
+        events.push_back(metadata("thread_name", CPU_PID, index + 1, name));
+    }
+
+    for(const auto& frame: m_frames) {
+        events.push_back({{"ph", "X"},
+                          {"name", fmt::format("Frame {}", frame.index)},
+                          {"pid", CPU_PID},
+                          {"tid", FRAMES_TID},
+                          {"ts", toUs(frame.startNs)},
+                          {"dur", (double)(frame.endNs - frame.startNs) / 1000.0}});
+        events.push_back({{"ph", "i"}, {"name", "Frame"}, {"s", "g"}, {"pid", CPU_PID}, {"tid", FRAMES_TID}, {"ts", toUs(frame.startNs)}});
+    }
+
+    for(const auto& zone: m_zones) {
+        events.push_back({{"ph", "X"},
+                          {"name", zone.event.name},
+                          {"pid", CPU_PID},
+                          {"tid", zone.threadIndex + 1},
+                          {"ts", toUs(zone.event.startNs)},
+                          {"dur", (double)(zone.event.endNs - zone.event.startNs) / 1000.0}});
+    }
+
+    for(const auto& range: m_gpuRanges) {
+        events.push_back({{"ph", "X"},
+                          {"name", range.name},
+                          {"pid", GPU_PID},
+                          {"tid", 0},
+                          {"ts", toUs(range.startNs)},
+                          {"dur", (double)(range.endNs - range.startNs) / 1000.0}});
+    }
+
+    for(const auto& counter: m_counters) {
+        events.push_back({{"ph", "C"}, {"name", counter.name}, {"pid", CPU_PID}, {"ts", toUs(counter.timeNs)}, {"args", {{"value", counter.value}}}});
+    }
+
+    std::error_code err;
+    fs::create_directories(m_path.parent_path(), err);
+
+    std::ofstream out(m_path);
+    if(!out) {
+        RAYGUN_ERROR("Unable to write trace: {}", m_path);
+        return;
+    }
+
+    out << json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}}.dump();
+
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_INFO("Trace of {} frames written to {} in {:.2f} ms", m_frames.size(), m_path, duration.count());
+}
+
+} // namespace raygun::profiling
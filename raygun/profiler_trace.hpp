@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/profiler_zones.hpp"
+
+namespace raygun::profiling {
+
+/// Collects profiler data over several frames and writes it as Chrome
+/// trace event JSON, which can be opened in chrome://tracing or
+/// ui.perfetto.dev. All timestamps are on the timestampNs() timeline.
+class TraceCapture {
+  public:
+    /// The capture ends after the given number of frames or seconds,
+    /// whichever comes first. A limit of 0 is ignored. Data from before
+    /// startNs is discarded.
+    TraceCapture(fs::path path, uint32_t maxFrames, double maxSeconds, uint64_t startNs = timestampNs());
+
+    void addZones(const std::vector<ThreadZones>& threads);
+    void addGpuRange(const char* name, uint64_t startNs, uint64_t endNs);
+    void addFrame(uint64_t index, uint64_t startNs, uint64_t endNs);
+    void addCounter(const char* name, uint64_t timeNs, double value);
+
+    bool done() const;
+
+    void write() const;
+
+    const fs::path& path() const { return m_path; }
+
+  private:
+    struct CpuZone {
+        uint32_t threadIndex;
+        ZoneEvent event;
+    };
+
+    struct GpuRange {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    struct Frame {
+        uint64_t index;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    struct Counter {
+        const char* name;
+        uint64_t timeNs;
+        double value;
+    };
+
+    fs::path m_path;
+
+    uint32_t m_maxFrames;
+    double m_maxSeconds;
+
+    uint64_t m_startNs;
+
+    std::map<uint32_t, string> m_threadNames;
+
+    std::vector<CpuZone> m_zones;
+    std::vector<GpuRange> m_gpuRanges;
+    std::vector<Frame> m_frames;
+    std::vector<Counter> m_counters;
+};
+
+} // namespace raygun::profiling
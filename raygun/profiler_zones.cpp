@@ -0,0 +1,137 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/profiler_zones.hpp"
+
+namespace raygun::profiling {
+
+namespace {
+
+    constexpr uint64_t ZONE_BUFFER_CAPACITY = 1 << 14;
+
+    /// Per-thread zone storage. The events form a single producer (owning
+    /// thread), single consumer (collect) ring buffer, so recording a zone
+    /// never takes a lock.
+    struct ThreadState {
+        uint32_t index = 0;
+        string name;
+
+        uint32_t depth = 0;
+
+        std::atomic<uint64_t> head = 0;
+        std::atomic<uint64_t> tail = 0;
+        std::atomic<uint64_t> dropped = 0;
+
+        std::vector<ZoneEvent> events = std::vector<ZoneEvent>(ZONE_BUFFER_CAPACITY);
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadState>> registry;
+    uint32_t nextThreadIndex = 0;
+
+    ThreadState& threadState()
+    {
+        thread_local const auto state = [] {
+            auto state = std::make_shared<ThreadState>();
+
+            std::lock_guard lock(registryMutex);
+            state->index = nextThreadIndex++;
+            state->name = fmt::format("Thread {}", state->index);
+            registry.push_back(state);
+
+            return state;
+        }();
+
+        return *state;
+    }
+
+} // namespace
+
+void setThreadName(string_view name)
+{
+    auto& state = threadState();
+
+    std::lock_guard lock(registryMutex);
+    state.name = name;
+}
+
+void collect(std::vector<ThreadZones>& threads)
+{
+    std::lock_guard lock(registryMutex);
+
+    threads.resize(registry.size());
+
+    for(size_t i = 0; i < registry.size(); ++i) {
+        auto& state = *registry[i];
+        auto& thread = threads[i];
+
+        thread.threadIndex = state.index;
+        thread.threadName = state.name;
+        thread.events.clear();
+
+        const auto tail = state.tail.load(std::memory_order_relaxed);
+        const auto head = state.head.load(std::memory_order_acquire);
+        for(auto j = tail; j < head; ++j) {
+            thread.events.push_back(state.events[j % ZONE_BUFFER_CAPACITY]);
+        }
+        state.tail.store(head, std::memory_order_release);
+
+        thread.droppedEvents = state.dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    // Buffers of exited threads are only held by the registry, drop them once drained.
+    for(size_t i = registry.size(); i-- > 0;) {
+        if(registry[i].use_count() == 1 && threads[i].events.empty()) {
+            registry.erase(registry.begin() + i);
+            threads.erase(threads.begin() + i);
+        }
+    }
+}
+
+void Zone::begin(const char* name)
+{
+    auto& state = threadState();
+
+    m_name = name;
+    m_depth = state.depth++;
+    m_startNs = timestampNs();
+}
+
+void Zone::end()
+{
+    const auto endNs = timestampNs();
+
+    auto& state = threadState();
+    state.depth--;
+
+    const auto head = state.head.load(std::memory_order_relaxed);
+    if(head - state.tail.load(std::memory_order_acquire) >= ZONE_BUFFER_CAPACITY) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    state.events[head % ZONE_BUFFER_CAPACITY] = {m_name, m_startNs, endNs, m_depth};
+    state.head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace raygun::profiling
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/utils/macros.hpp"
+
+#ifdef RAYGUN_DISABLE_PROFILER
+    #define RAYGUN_PROFILE_ZONE(_name)
+#else
+    /// Records the enclosing scope as a CPU zone, the name must be a string
+    /// literal (or otherwise outlive the profiler).
+    #define RAYGUN_PROFILE_ZONE(_name) const ::raygun::profiling::Zone RAYGUN_CONCAT(_raygunProfileZone, __COUNTER__)(_name)
+#endif
+
+#define RAYGUN_PROFILE_FUNCTION() RAYGUN_PROFILE_ZONE(__func__)
+
+namespace raygun::profiling {
+
+/// Monotonic timestamp in nanoseconds, shared by all CPU zones.
+inline uint64_t timestampNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ZoneEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+    uint32_t depth;
+};
+
+/// Zones recorded by one thread since the last collect.
+struct ThreadZones {
+    uint32_t threadIndex = 0;
+    string threadName;
+    std::vector<ZoneEvent> events;
+    uint64_t droppedEvents = 0;
+};
+
+namespace detail {
+    inline std::atomic<bool> enabled = true;
+}
+
+/// Toggles zone recording at runtime, a disabled zone costs a single
+/// relaxed load.
+inline void setEnabled(bool enabled)
+{
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool enabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// Names the calling thread in the profiler UI and trace exports.
+void setThreadName(string_view name);
+
+/// Moves all zones recorded since the last call out of the per-thread
+/// buffers. Only one thread may collect.
+void collect(std::vector<ThreadZones>& threads);
+
+class Zone {
+  public:
+    explicit Zone(const char* name)
+    {
+        if(enabled()) begin(name);
+    }
+
+    ~Zone()
+    {
+        if(m_name) end();
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    void begin(const char* name);
+    void end();
+
+    const char* m_name = nullptr;
+    uint64_t m_startNs = 0;
+    uint32_t m_depth = 0;
+};
+
+} // namespace raygun::profiling
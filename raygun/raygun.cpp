@@ -33,6 +33,8 @@ static Raygun* instance;
 
 Raygun::Raygun(string_view title, UniqueConfig config)
 {
+    const auto startTime = Clock::now();
+
     if(instance) {
         RAYGUN_FATAL(RAYGUN_NAME " instance already initialized");
     }
@@ -57,6 +59,9 @@ Raygun::Raygun(string_view title, UniqueConfig config)
 
     m_vc = std::make_unique<VulkanContext>();
 
+    profiling::setEnabled(m_config->cpuProfiler);
+    profiling::setThreadName("Main");
+
     m_profiler = std::make_unique<Profiler>();
 
     m_computeSystem = std::make_unique<compute::ComputeSystem>();
@@ -70,7 +75,8 @@ Raygun::Raygun(string_view title, UniqueConfig config)
 
     loadScene(std::make_unique<Scene>());
 
-    RAYGUN_INFO(RAYGUN_NAME " initialized");
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_INFO(RAYGUN_NAME " initialized in {:.2f} ms ({} start)", duration.count(), m_vc->pipelineCache->warm() ? "warm" : "cold");
 }
 
 Raygun::~Raygun()
@@ -79,6 +85,12 @@ Raygun::~Raygun()
     // in use.
     m_vc->waitIdle();
 
+    // Scenes are released while the instance is still accessible, entities
+    // unregister their physics actors on destruction.
+    m_physicsSystem->endSimulation();
+    m_nextScene.reset();
+    m_scene.reset();
+
     instance = nullptr;
 }
 
@@ -101,10 +113,18 @@ void Raygun::loop()
 
         const auto input = m_inputSystem->handleEvents();
 
-        const auto timeDelta = updateTimestamp();
+        const auto frameDelta = updateTimestamp();
+        const auto timeDelta = std::chrono::duration<double>(frameDelta).count();
+
+        m_profiler->count(CounterID::FrameArenaKiB, (uint32_t)(m_frameArena.bytesUsed() / 1024));
+        m_frameArena.reset();
 
         m_profiler->startFrame();
 
+        // A physics step started during the last frame must be done before
+        // input, UI or a scene load may touch the physics scene.
+        m_physicsSystem->endSimulation();
+
         if(m_nextScene) {
             finalizeLoadScene();
         }
@@ -113,25 +133,19 @@ void Raygun::loop()
 
         m_scene->preSimulation();
 
-        m_physicsSystem->update(timeDelta);
-
         if(!ui::runUI(*m_scene->root, timeDelta, input)) {
             m_scene->processInput(input, timeDelta);
         }
 
-        m_scene->root->forEachEntity([timeDelta](auto& ent) {
-            if(auto animEnt = dynamic_cast<AnimatableEntity*>(&ent)) {
-                animEnt->update(timeDelta);
-            }
-        });
-
-        m_scene->update(timeDelta);
+        m_profiler->count(CounterID::SimulationSteps, simulate(frameDelta));
 
         m_audioSystem->update();
 
         m_renderSystem->render(*m_scene);
     }
 
+    m_physicsSystem->endSimulation();
+
     RAYGUN_INFO("End main loop");
 }
 
@@ -255,7 +269,17 @@ double Raygun::time()
     return std::chrono::duration<double>(m_time).count();
 }
 
-double Raygun::updateTimestamp()
+utils::Arena& Raygun::frameArena()
+{
+    return m_frameArena;
+}
+
+float Raygun::interpolationFactor()
+{
+    return m_interpolationFactor;
+}
+
+Clock::duration Raygun::updateTimestamp()
 {
     using namespace std::chrono_literals;
 
@@ -268,21 +292,104 @@ double Raygun::updateTimestamp()
     // here affects the whole simulation (not just physics) equally.
     delta = std::min<Clock::duration>(delta, 50ms);
 
+    // Deterministic runs (e.g. benchmarks) advance by the same amount every frame.
+    if(m_config->fixedTimeDelta > 0.0) {
+        delta = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_config->fixedTimeDelta));
+    }
+
     m_time += delta;
 
-    return std::chrono::duration<double>(delta).count();
+    return delta;
+}
+
+uint32_t Raygun::simulate(Clock::duration timeDelta)
+{
+    RAYGUN_PROFILE_ZONE("Simulation");
+
+    // Variable time steps, the current state is rendered as is.
+    if(m_config->simulationRate <= 0.0) {
+        simulationStep(std::chrono::duration<double>(timeDelta).count());
+        m_interpolationFactor = 1.0f;
+        return 1;
+    }
+
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_config->simulationRate));
+    const auto maxSteps = (uint32_t)std::max(m_config->maxSimulationSteps, 1);
+
+    m_simulationAccumulator += timeDelta;
+
+    uint32_t steps = 0;
+    while(m_simulationAccumulator >= step && steps < maxSteps) {
+        m_scene->root->forEachEntity([](Entity& entity) { entity.storePreviousTransform(); });
+
+        simulationStep(std::chrono::duration<double>(step).count());
+
+        m_simulationAccumulator -= step;
+        steps++;
+    }
+
+    // Drop what could not be simulated in time, otherwise the simulation
+    // would fall behind further and further.
+    if(m_simulationAccumulator >= step) {
+        m_simulationAccumulator %= step;
+    }
+
+    m_interpolationFactor = (float)(std::chrono::duration<double>(m_simulationAccumulator).count() / std::chrono::duration<double>(step).count());
+
+    return steps;
+}
+
+void Raygun::simulationStep(double timeDelta)
+{
+    m_scene->m_inSimulationStep = true;
+
+    // With physics overlap enabled, a physics step runs in the background
+    // from the end of one simulation step until the next one or the start of
+    // the next frame, overlapping with audio and rendering.
+    if(m_config->physicsOverlap) {
+        m_physicsSystem->endSimulation();
+    }
+    else {
+        m_physicsSystem->update(timeDelta);
+    }
+
+    {
+        RAYGUN_PROFILE_ZONE("Animation");
+
+        m_scene->root->forEachEntity([timeDelta](auto& ent) {
+            if(auto animEnt = dynamic_cast<AnimatableEntity*>(&ent)) {
+                animEnt->update(timeDelta);
+            }
+        });
+    }
+
+    {
+        RAYGUN_PROFILE_ZONE("Scene Update");
+        m_scene->update(timeDelta);
+    }
+
+    if(m_config->physicsOverlap) {
+        m_physicsSystem->beginSimulation(timeDelta);
+    }
+
+    m_scene->m_inSimulationStep = false;
 }
 
 void Raygun::finalizeLoadScene()
 {
     RAYGUN_INFO("Loading scene");
 
-    m_vc->device->waitIdle();
+    // The physics scene must not be simulating when released.
+    m_physicsSystem->endSimulation();
 
     std::swap(m_scene, m_nextScene);
     m_nextScene.reset();
 
-    m_resourceManager->clearUnusedModelsAndMaterials();
+    m_physicsSystem->purgeSharedMeshes();
+
+    // Bottom level structures of removed models may still be referenced by
+    // the frame in flight.
+    m_renderSystem->retire(m_resourceManager->clearUnusedModelsAndMaterials());
 
     m_renderSystem->resetUniformBuffer();
 
@@ -290,6 +397,8 @@ void Raygun::finalizeLoadScene()
     m_renderSystem->raytracer().setupBottomLevelAS();
 
     m_timestamp = Clock::now();
+    m_simulationAccumulator = Clock::duration::zero();
+    m_interpolationFactor = 1.0f;
 
     m_scene->camera->updateProjection();
 }
@@ -32,6 +32,7 @@
 #include "raygun/render/render_system.hpp"
 #include "raygun/resource_manager.hpp"
 #include "raygun/scene.hpp"
+#include "raygun/utils/arena.hpp"
 #include "raygun/utils/glfw_utils.hpp"
 #include "raygun/vulkan_context.hpp"
 #include "raygun/window.hpp"
@@ -80,10 +81,20 @@ class Raygun {
     /// Returns the active time passed since engine initialization.
     double time();
 
+    /// Position of the current frame between the previous and the current
+    /// simulation step, used to interpolate rendered transforms.
+    float interpolationFactor();
+
+    /// Scratch memory for transient data of the current frame. Reset at the
+    /// beginning of every frame, main thread only.
+    utils::Arena& frameArena();
+
   private:
     // The order of these members is important as they dictate the sequence of
     // destruction. Think twice before changing something here.
 
+    utils::Arena m_frameArena;
+
     UniqueConfig m_config;
 
     glfw::UniqueRuntime m_glfwRuntime;
@@ -115,8 +126,18 @@ class Raygun {
 
     Clock::time_point m_timestamp = Clock::now();
 
+    Clock::duration m_simulationAccumulator = Clock::duration::zero();
+
+    float m_interpolationFactor = 1.0f;
+
     /// Updates the internal time tracking and returns the time-delta.
-    double updateTimestamp();
+    Clock::duration updateTimestamp();
+
+    /// Runs as many fixed simulation steps as fit into the accumulated time,
+    /// returns the number of steps taken.
+    uint32_t simulate(Clock::duration timeDelta);
+
+    void simulationStep(double timeDelta);
 
     void finalizeLoadScene();
 };
@@ -23,9 +23,11 @@
 #include "raygun/render/acceleration_structure.hpp"
 
 #include "raygun/gpu/gpu_utils.hpp"
+#include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
 #include "raygun/render/model.hpp"
 #include "raygun/scene.hpp"
+#include "raygun/transform_batch.hpp"
 
 namespace raygun::render {
 
@@ -40,9 +42,7 @@ namespace {
         instance.setMask(0xff);
         instance.setFlags(vk::GeometryInstanceFlagBitsKHR::eTriangleCullDisable);
 
-        // 3x4 row-major affine transformation matrix.
-        const auto transform = glm::transpose(entity.globalTransform().toMat4());
-        instance.transform.matrix = *reinterpret_cast<const vk::ArrayWrapper2D<float, 3, 4>*>(&transform);
+        // The transformation matrix is filled in batches, see TopLevelAS::build.
 
         const auto blasAddress = device.getAccelerationStructureAddressKHR({vk::AccelerationStructureKHR(*entity.model->bottomLevelAS)});
         instance.setAccelerationStructureReference(blasAddress);
@@ -50,14 +50,34 @@ namespace {
         return instance;
     }
 
+    vk::AccelerationStructureGeometryKHR instancesGeometry(vk::DeviceAddress instances)
+    {
+        vk::AccelerationStructureGeometryInstancesDataKHR instancesData = {};
+        instancesData.setData(instances);
+
+        vk::AccelerationStructureGeometryDataKHR geometryData = {};
+        geometryData.setInstances(instancesData);
+
+        vk::AccelerationStructureGeometryKHR geometry = {};
+        geometry.setGeometryType(vk::GeometryTypeKHR::eInstances);
+        geometry.setGeometry(geometryData);
+
+        return geometry;
+    }
+
 } // namespace
 
-TopLevelAS::TopLevelAS(const vk::CommandBuffer& cmd, const Scene& scene)
+void TopLevelAS::build(const vk::CommandBuffer& cmd, const Scene& scene)
 {
     VulkanContext& vc = RG().vc();
 
-    std::vector<vk::AccelerationStructureInstanceKHR> instances;
-    std::vector<InstanceOffsetTableEntry> instanceOffsetTable;
+    m_instanceData.clear();
+    m_instanceOffsetData.clear();
+
+    auto& arena = RG().frameArena();
+    utils::ArenaVector<Transform> parentTransforms(arena);
+    utils::ArenaVector<Transform> localTransforms(arena);
+    utils::ArenaVector<const Transform*> previousTransforms(arena);
 
     // Grab instances from scene.
     scene.root->forEachEntity([&](const Entity& entity) {
@@ -69,14 +89,18 @@ TopLevelAS::TopLevelAS(const vk::CommandBuffer& cmd, const Scene& scene)
         // if no model, then we skip this, but might still render children
         if(!entity.model) return true;
 
-        const auto instance = instanceFromEntity(*vc.device, entity, (uint32_t)instances.size());
-        instances.push_back(instance);
+        const auto instance = instanceFromEntity(*vc.device, entity, (uint32_t)m_instanceData.size());
+        m_instanceData.push_back(instance);
+
+        parentTransforms.push_back(entity.parentTransform());
+        localTransforms.push_back(entity.transform());
+        previousTransforms.push_back(entity.previousTransform() ? &*entity.previousTransform() : nullptr);
 
         const auto& vertexBufferRef = entity.model->mesh->vertexBufferRef;
         const auto& indexBufferRef = entity.model->mesh->indexBufferRef;
         const auto& materialBufferRef = entity.model->materialBufferRef;
 
-        auto& entry = instanceOffsetTable.emplace_back();
+        auto& entry = m_instanceOffsetData.emplace_back();
         entry.vertexBufferOffset = vertexBufferRef.offsetInElements();
         entry.indexBufferOffset = indexBufferRef.offsetInElements();
         entry.materialBufferOffset = materialBufferRef.offsetInElements();
@@ -84,29 +108,91 @@ TopLevelAS::TopLevelAS(const vk::CommandBuffer& cmd, const Scene& scene)
         return true;
     });
 
-    m_instances = gpu::copyToBuffer(instances, vk::BufferUsageFlagBits::eShaderDeviceAddress);
-    m_instances->setName("TLAS Instances");
+    const auto instanceCount = (uint32_t)m_instanceData.size();
+
+    // 3x4 row-major affine transformation matrices, written in place.
+    if(instanceCount > 0) {
+        auto matrices = m_instanceData[0].transform.matrix[0].data();
+        const auto stride = sizeof(vk::AccelerationStructureInstanceKHR);
+
+        const auto factor = RG().interpolationFactor();
+        if(factor >= 1.0f) {
+            composeMatrices(parentTransforms.data(), localTransforms.data(), matrices, stride, instanceCount);
+        }
+        else {
+            // Render in between the previous and the current simulation step.
+            auto& globalTransforms = localTransforms;
+            composeTransforms(parentTransforms.data(), localTransforms.data(), globalTransforms.data(), instanceCount);
+
+            for(uint32_t i = 0; i < instanceCount; ++i) {
+                if(previousTransforms[i]) {
+                    globalTransforms[i] = interpolate(*previousTransforms[i], globalTransforms[i], factor);
+                }
+            }
+
+            toMatrices(globalTransforms.data(), matrices, stride, instanceCount);
+        }
+    }
 
-    m_instanceOffsetTable = gpu::copyToBuffer(instanceOffsetTable, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
-    m_instanceOffsetTable->setName("Instance Offset Table");
+    reserve(instanceCount);
 
-    vk::AccelerationStructureGeometryInstancesDataKHR instancesData = {};
-    instancesData.setData(m_instances->address());
+    // Only one frame is in flight (see RenderSystem::m_frameValue) and it has
+    // completed, so instance data can be overwritten.
+    memcpy(m_instances->map(), m_instanceData.data(), instanceCount * sizeof(m_instanceData[0]));
+    memcpy(m_instanceOffsetTable->map(), m_instanceOffsetData.data(), instanceCount * sizeof(m_instanceOffsetData[0]));
 
-    vk::AccelerationStructureGeometryDataKHR geometryData = {};
-    geometryData.setInstances(instancesData);
+    auto geometry = instancesGeometry(m_instances->address());
 
-    vk::AccelerationStructureGeometryKHR geometry = {};
-    geometry.setGeometryType(vk::GeometryTypeKHR::eInstances);
-    geometry.setGeometry(geometryData);
+    vk::AccelerationStructureBuildGeometryInfoKHR buildInfo = {};
+    buildInfo.setPGeometries(&geometry);
+    buildInfo.setGeometryCount(1);
+    buildInfo.setType(vk::AccelerationStructureTypeKHR::eTopLevel);
+    buildInfo.setDstAccelerationStructure(*m_structure);
+    buildInfo.setScratchData(m_scratch->address());
+
+    vk::AccelerationStructureBuildRangeInfoKHR offset = {};
+    offset.setPrimitiveCount(instanceCount);
+
+    cmd.buildAccelerationStructuresKHR(buildInfo, &offset);
+}
+
+void TopLevelAS::reserve(uint32_t instanceCount)
+{
+    if(m_structure && instanceCount <= m_instanceCapacity) return;
+
+    VulkanContext& vc = RG().vc();
+
+    // Storage may still be in use by the previous frame.
+    if(m_structure) {
+        auto& renderSystem = RG().renderSystem();
+        renderSystem.retire(std::move(m_structure));
+        renderSystem.retire(std::move(m_structureMemory));
+        renderSystem.retire(std::move(m_instances));
+        renderSystem.retire(std::move(m_scratch));
+        renderSystem.retire(std::move(m_instanceOffsetTable));
+    }
+
+    m_instanceCapacity = std::max({instanceCount, m_instanceCapacity * 2, MIN_INSTANCE_CAPACITY});
+
+    constexpr auto hostMemory = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    m_instances = std::make_unique<gpu::Buffer>(m_instanceCapacity * sizeof(vk::AccelerationStructureInstanceKHR),
+                                                vk::BufferUsageFlagBits::eShaderDeviceAddress, hostMemory);
+    m_instances->setName("TLAS Instances");
+
+    m_instanceOffsetTable = std::make_unique<gpu::Buffer>(m_instanceCapacity * sizeof(InstanceOffsetTableEntry),
+                                                          vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress, hostMemory);
+    m_instanceOffsetTable->setName("Instance Offset Table");
+
+    auto geometry = instancesGeometry(m_instances->address());
 
     vk::AccelerationStructureBuildGeometryInfoKHR buildInfo = {};
     buildInfo.setPGeometries(&geometry);
     buildInfo.setGeometryCount(1);
     buildInfo.setType(vk::AccelerationStructureTypeKHR::eTopLevel);
 
-    const auto buildSize =
-        vc.device->getAccelerationStructureBuildSizesKHR(vk::AccelerationStructureBuildTypeKHR::eDevice, buildInfo, (uint32_t)instances.size());
+    // Sizes for the maximum instance count are valid for all smaller builds.
+    const auto buildSize = vc.device->getAccelerationStructureBuildSizesKHR(vk::AccelerationStructureBuildTypeKHR::eDevice, buildInfo, m_instanceCapacity);
 
     vk::AccelerationStructureCreateInfoKHR createInfo = {};
     createInfo.setType(vk::AccelerationStructureTypeKHR::eTopLevel);
@@ -120,21 +206,16 @@ TopLevelAS::TopLevelAS(const vk::CommandBuffer& cmd, const Scene& scene)
 
     m_structure = vc.device->createAccelerationStructureKHRUnique(createInfo);
     vc.setObjectName(*m_structure, "TLAS Structure");
-    buildInfo.setDstAccelerationStructure(*m_structure);
 
     m_scratch =
         std::make_unique<gpu::Buffer>(buildSize.buildScratchSize, vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eStorageBuffer,
                                       vk::MemoryPropertyFlagBits::eDeviceLocal);
     m_scratch->setName("TLAS Scratch");
-    buildInfo.setScratchData(m_scratch->address());
-
-    vk::AccelerationStructureBuildRangeInfoKHR offset = {};
-    offset.setPrimitiveCount((uint32_t)instances.size());
-
-    cmd.buildAccelerationStructuresKHR(buildInfo, &offset);
 
     m_descriptorInfo.setAccelerationStructureCount(1);
     m_descriptorInfo.setPAccelerationStructures(&*m_structure);
+
+    RAYGUN_DEBUG("TLAS storage allocated for {} instances", m_instanceCapacity);
 }
 
 BottomLevelAS::BottomLevelAS(const vk::CommandBuffer& cmd, const Mesh& mesh)
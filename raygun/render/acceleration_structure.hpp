@@ -31,9 +31,18 @@ struct Scene;
 
 namespace raygun::render {
 
+struct InstanceOffsetTableEntry {
+    using uint = uint32_t;
+#include "resources/shaders/instance_offset_table.def"
+};
+
+/// Top level acceleration structure which is rebuilt every frame. Storage is
+/// reused across builds and only grows when the number of instances exceeds
+/// its capacity, keeping the handle stable in the common case.
 class TopLevelAS {
   public:
-    TopLevelAS(const vk::CommandBuffer& cmd, const Scene& scene);
+    /// Records a build with the scene's current instances.
+    void build(const vk::CommandBuffer& cmd, const Scene& scene);
 
     operator vk::AccelerationStructureKHR() const { return *m_structure; }
 
@@ -42,8 +51,12 @@ class TopLevelAS {
     const vk::WriteDescriptorSetAccelerationStructureKHR& descriptorInfo() const { return m_descriptorInfo; }
 
   private:
+    static constexpr uint32_t MIN_INSTANCE_CAPACITY = 64;
+
     vk::WriteDescriptorSetAccelerationStructureKHR m_descriptorInfo = {};
 
+    uint32_t m_instanceCapacity = 0;
+
     vk::UniqueAccelerationStructureKHR m_structure;
     gpu::UniqueBuffer m_structureMemory;
     gpu::UniqueBuffer m_instances;
@@ -54,6 +67,13 @@ class TopLevelAS {
     /// to a specific primitive, the offsets in these buffers must be known.
     /// This lookup table provides the needed offsets for each instance.
     gpu::UniqueBuffer m_instanceOffsetTable;
+
+    // Gathered on the CPU before being copied to the buffers above, kept to
+    // avoid reallocating every frame.
+    std::vector<vk::AccelerationStructureInstanceKHR> m_instanceData;
+    std::vector<InstanceOffsetTableEntry> m_instanceOffsetData;
+
+    void reserve(uint32_t instanceCount);
 };
 
 using UniqueTopLevelAS = std::unique_ptr<TopLevelAS>;
@@ -72,11 +92,6 @@ class BottomLevelAS {
 
 using UniqueBottomLevelAS = std::unique_ptr<BottomLevelAS>;
 
-struct InstanceOffsetTableEntry {
-    using uint = uint32_t;
-#include "resources/shaders/instance_offset_table.def"
-};
-
 void accelerationStructureBarrier(const vk::CommandBuffer& cmd);
 
 } // namespace raygun::render
@@ -23,6 +23,7 @@
 #include "raygun/render/imgui_renderer.hpp"
 
 #include "raygun/config.hpp"
+#include "raygun/gpu/command_batch.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
 #include "raygun/render/render_system.hpp"
@@ -121,16 +122,11 @@ void ImGuiRenderer::setupForVulkan()
 
 void ImGuiRenderer::setupFonts()
 {
-    auto cmd = vc.graphicsQueue->createCommandBuffer();
-    cmd->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    gpu::CommandBatch batch(*vc.graphicsQueue, "ImGui Fonts");
 
-    ImGui_ImplVulkan_CreateFontsTexture(*cmd);
+    ImGui_ImplVulkan_CreateFontsTexture(batch.commandBuffer());
 
-    cmd->end();
-
-    vc.graphicsQueue->submit(*cmd);
-
-    vc.waitIdle();
+    batch.submit().wait();
 
     ImGui_ImplVulkan_DestroyFontUploadObjects();
 }
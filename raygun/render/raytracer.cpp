@@ -35,6 +35,27 @@
 
 namespace raygun::render {
 
+namespace {
+
+    constexpr std::array RAYGEN_SHADERS = {"raygen.rgen"};
+    constexpr std::array MISS_SHADERS = {"miss.rmiss", "shadowMiss.rmiss"};
+    constexpr std::array CLOSEST_HIT_SHADERS = {"closesthit.rchit"};
+
+    // Render target dimensions are rounded up to this, so that resizing the
+    // window does not reallocate them every time.
+    constexpr uint32_t RENDER_TARGET_GRANULARITY = 256;
+
+    vk::Extent2D renderTargetCapacity(vk::Extent2D extent)
+    {
+        const auto roundUp = [](uint32_t value) {
+            return std::max(1u, (value + RENDER_TARGET_GRANULARITY - 1) / RENDER_TARGET_GRANULARITY) * RENDER_TARGET_GRANULARITY;
+        };
+
+        return {roundUp(extent.width), roundUp(extent.height)};
+    }
+
+} // namespace
+
 Raytracer::Raytracer() : vc(RG().vc())
 {
     auto properties = vc.physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceRayTracingPipelinePropertiesKHR>();
@@ -44,40 +65,41 @@ Raytracer::Raytracer() : vc(RG().vc())
 
     setupPostprocessing();
 
+    m_imageCapacity = renderTargetCapacity(vc.windowSize);
     setupRaytracingImages();
 
-    setupRaytracingPipeline();
+    setupRaytracingPipelineLayout();
+
+    m_pipeline = createRaytracingPipeline(loadShaders());
 
     RAYGUN_INFO("Raytracer initialized");
 }
 
 void Raytracer::setupBottomLevelAS()
 {
-    auto cmd = vc.computeQueue->createCommandBuffer();
-    vc.setObjectName(*cmd, "BLAS");
-
-    auto fence = vc.device->createFenceUnique({});
-    vc.setObjectName(*fence, "BLAS");
-
-    cmd->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    gpu::CommandBatch batch(*vc.computeQueue, "BLAS");
 
     auto models = RG().resourceManager().models();
     for(auto& model: models) {
         if(!model->bottomLevelAS) {
-            model->bottomLevelAS = std::make_unique<BottomLevelAS>(*cmd, *model->mesh);
+            model->bottomLevelAS = std::make_unique<BottomLevelAS>(batch.commandBuffer(), *model->mesh);
         }
     }
 
-    cmd->end();
-    vc.computeQueue->submit(*cmd, *fence);
-    vc.waitForFence(*fence);
+    // Waited for before building the next top level AS.
+    m_bottomLevelASReady = batch.submit();
 }
 
 void Raytracer::setupTopLevelAS(vk::CommandBuffer& cmd, const Scene& scene)
 {
+    RAYGUN_PROFILE_ZONE("TLAS Build");
+
+    // The top level AS is built on a different queue.
+    m_bottomLevelASReady.wait();
+
     RG().profiler().writeTimestamp(cmd, TimestampQueryID::ASBuildStart);
 
-    m_topLevelAS = std::make_unique<TopLevelAS>(cmd, scene);
+    m_topLevelAS.build(cmd, scene);
 
     accelerationStructureBarrier(cmd);
 
@@ -86,7 +108,11 @@ void Raytracer::setupTopLevelAS(vk::CommandBuffer& cmd, const Scene& scene)
 
 const gpu::Image& Raytracer::doRaytracing(vk::CommandBuffer& cmd)
 {
-    cmd.bindPipeline(vk::PipelineBindPoint::eRayTracingKHR, *m_pipeline);
+    // History images must be in general layout before their content is
+    // used, all other images are transitioned below.
+    m_imagesReady.wait();
+
+    cmd.bindPipeline(vk::PipelineBindPoint::eRayTracingKHR, *m_pipeline->pipeline);
 
     cmd.bindDescriptorSets(vk::PipelineBindPoint::eRayTracingKHR, *m_pipelineLayout, 0, m_descriptorSet.set(), {});
 
@@ -96,7 +122,7 @@ const gpu::Image& Raytracer::doRaytracing(vk::CommandBuffer& cmd)
 
     initialImageBarrier(cmd);
 
-    cmd.traceRaysKHR(m_raygenSbt, m_missSbt, m_hitSbt, m_callableSbt, //
+    cmd.traceRaysKHR(m_pipeline->raygenSbt, m_pipeline->missSbt, m_pipeline->hitSbt, m_pipeline->callableSbt, //
                      vc.windowSize.width, vc.windowSize.height, 1);
 
     computeShaderImageBarrier(cmd, {m_baseImage.get(), m_normalImage.get(), m_roughImage.get()}, vk::PipelineStageFlagBits::eRayTracingShaderKHR);
@@ -108,6 +134,15 @@ const gpu::Image& Raytracer::doRaytracing(vk::CommandBuffer& cmd)
     int dispatchWidth = vc.windowSize.width / COMPUTE_WG_X_SIZE + ((vc.windowSize.width % COMPUTE_WG_X_SIZE) > 0 ? 1 : 0);
     int dispatchHeight = vc.windowSize.height / COMPUTE_WG_Y_SIZE + ((vc.windowSize.height % COMPUTE_WG_Y_SIZE) > 0 ? 1 : 0);
 
+    RG().profiler().writeTimestamp(cmd, TimestampQueryID::TemporalStart);
+
+    m_temporalResolve->dispatch(cmd, dispatchWidth, dispatchHeight);
+    computeShaderImageBarrier(cmd, {m_temporalOutput.get()});
+    m_temporalStore->dispatch(cmd, dispatchWidth, dispatchHeight);
+    computeShaderImageBarrier(cmd, {m_baseImage.get(), m_historyColor.get(), m_historyNormal.get()});
+
+    RG().profiler().writeTimestamp(cmd, TimestampQueryID::TemporalEnd);
+
     RG().profiler().writeTimestamp(cmd, TimestampQueryID::RoughStart);
 
     m_roughPrepare->dispatch(cmd, dispatchWidth, dispatchHeight);
@@ -135,8 +170,8 @@ const gpu::Image& Raytracer::doRaytracing(vk::CommandBuffer& cmd)
 
     ImGui::Checkbox("Use FXAA", &m_useFXAA);
     if(m_useFXAA) {
+        // Writes the anti-aliased result to the base image.
         m_fxaa->dispatch(cmd, dispatchWidth, dispatchHeight);
-        std::swap(m_baseImage, m_finalImage);
     }
 
     RG().profiler().writeTimestamp(cmd, TimestampQueryID::PostprocEnd);
@@ -150,7 +185,7 @@ void Raytracer::updateRenderTarget(const gpu::Buffer& uniformBuffer, const gpu::
                                    const gpu::Buffer& materialBuffer)
 {
     // Bind acceleration structure
-    m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_ACCELERATION_STRUCTURE, *m_topLevelAS);
+    m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_ACCELERATION_STRUCTURE, m_topLevelAS);
 
     // Bind images
     m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_OUTPUT_IMAGE, *m_baseImage);
@@ -162,36 +197,121 @@ void Raytracer::updateRenderTarget(const gpu::Buffer& uniformBuffer, const gpu::
     m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_VERTEX_BUFFER, vertexBuffer);
     m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_INDEX_BUFFER, indexBuffer);
     m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_MATERIAL_BUFFER, materialBuffer);
-    m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_INSTANCE_OFFSET_TABLE, m_topLevelAS->instanceOffsetTable());
+    m_descriptorSet.bind(RAYGUN_RAYTRACER_BINDING_INSTANCE_OFFSET_TABLE, m_topLevelAS.instanceOffsetTable());
 
     m_descriptorSet.update();
 
-    RG().computeSystem().updateDescriptors(
-        uniformBuffer, {&*m_finalImage, &*m_baseImage, &*m_normalImage, &*m_roughImage, &*m_roughTransitions, &*m_roughColorsA, &*m_roughColorsB});
+    RG().computeSystem().updateDescriptors(uniformBuffer, {&*m_finalImage, &*m_baseImage, &*m_normalImage, &*m_roughImage, &*m_roughTransitions,
+                                                           &*m_roughColorsA, &*m_roughColorsB, &*m_historyColor, &*m_historyNormal, &*m_temporalOutput});
+}
+
+void Raytracer::resize(vk::Extent2D extent)
+{
+    const auto fits = extent.width <= m_imageCapacity.width && extent.height <= m_imageCapacity.height;
+
+    // Do not hold on to large render targets after the window has shrunk
+    // considerably.
+    const auto capacity = renderTargetCapacity(extent);
+    const auto wasteful = (uint64_t)m_imageCapacity.width * m_imageCapacity.height > 4ull * capacity.width * capacity.height;
+
+    if(fits && !wasteful) {
+        RAYGUN_DEBUG("Render targets reused for {}x{} (capacity {}x{})", extent.width, extent.height, m_imageCapacity.width, m_imageCapacity.height);
+        return;
+    }
+
+    m_imageCapacity = capacity;
+    setupRaytracingImages();
+
+    RAYGUN_DEBUG("Render targets reallocated for {}x{} (capacity {}x{})", extent.width, extent.height, m_imageCapacity.width, m_imageCapacity.height);
+}
+
+void Raytracer::reloadShaders(const std::set<string>& changedShaders)
+{
+    const auto changed = [&](const auto& names) {
+        return std::any_of(names.begin(), names.end(), [&](const char* name) { return changedShaders.count(name) > 0; });
+    };
+
+    if(!changed(RAYGEN_SHADERS) && !changed(MISS_SHADERS) && !changed(CLOSEST_HIT_SHADERS)) {
+        return;
+    }
+
+    // Only one rebuild in flight.
+    if(m_pendingPipeline.valid()) {
+        m_pendingPipeline.wait();
+        swapPipeline();
+    }
+
+    // Shaders are loaded on the calling thread, the resource manager is not
+    // thread-safe. Pipeline and shader binding table are created in the
+    // background.
+    m_pendingPipeline = std::async(std::launch::async, [this, shaders = loadShaders()] { return createRaytracingPipeline(shaders); });
+}
+
+void Raytracer::swapPipeline()
+{
+    if(!m_pendingPipeline.valid() || m_pendingPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    UniqueRaytracingPipeline pipeline;
+    try {
+        pipeline = m_pendingPipeline.get();
+    }
+    catch(const std::exception& e) {
+        RAYGUN_WARN("Unable to rebuild ray tracing pipeline: {}", e.what());
+        return;
+    }
+
+    RG().renderSystem().retire(std::move(m_pipeline));
+    m_pipeline = std::move(pipeline);
+
+    RAYGUN_INFO("Ray tracing pipeline swapped");
 }
 
 void Raytracer::setupRaytracingImages()
 {
-    m_baseImage = std::make_unique<gpu::Image>(vc.windowSize);
+    // Previous render targets may still be in use when resizing.
+    if(m_baseImage) {
+        auto& renderSystem = RG().renderSystem();
+        for(auto image: {&m_baseImage, &m_normalImage, &m_roughImage, &m_finalImage, &m_roughTransitions, &m_roughColorsA, &m_roughColorsB,
+                         &m_historyColor, &m_historyNormal, &m_temporalOutput}) {
+            renderSystem.retire(std::move(*image));
+        }
+    }
+
+    gpu::CommandBatch batch(*vc.graphicsQueue, "RT Images");
+
+    m_baseImage = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_baseImage->setName("RT Base Image");
 
-    m_normalImage = std::make_unique<gpu::Image>(vc.windowSize);
+    m_normalImage = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_normalImage->setName("RT Normal Image");
 
-    m_roughImage = std::make_unique<gpu::Image>(vc.windowSize);
+    m_roughImage = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_roughImage->setName("RT Rough Image");
 
-    m_finalImage = std::make_unique<gpu::Image>(vc.windowSize);
+    m_finalImage = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_finalImage->setName("RT Final Image");
 
-    m_roughTransitions = std::make_unique<gpu::Image>(vc.windowSize, vk::Format::eR8Snorm);
+    m_roughTransitions = std::make_unique<gpu::Image>(batch, m_imageCapacity, vk::Format::eR8Snorm);
     m_roughTransitions->setName("RT Rough Transition");
 
-    m_roughColorsA = std::make_unique<gpu::Image>(vc.windowSize);
+    m_roughColorsA = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_roughColorsA->setName("RT Rough Color A");
 
-    m_roughColorsB = std::make_unique<gpu::Image>(vc.windowSize);
+    m_roughColorsB = std::make_unique<gpu::Image>(batch, m_imageCapacity);
     m_roughColorsB->setName("RT Rough Color B");
+
+    m_historyColor = std::make_unique<gpu::Image>(batch, m_imageCapacity);
+    m_historyColor->setName("RT History Color");
+
+    m_historyNormal = std::make_unique<gpu::Image>(batch, m_imageCapacity);
+    m_historyNormal->setName("RT History Normal");
+
+    m_temporalOutput = std::make_unique<gpu::Image>(batch, m_imageCapacity);
+    m_temporalOutput->setName("RT Temporal Output");
+
+    m_imagesReady = batch.submit();
 }
 
 void Raytracer::setupRaytracingDescriptorSet()
@@ -242,20 +362,41 @@ namespace {
 
 } // namespace
 
-void Raytracer::setupRaytracingPipeline()
+void Raytracer::setupRaytracingPipelineLayout()
 {
-    // shaders
-    const auto raygenShaders = std::array{
-        RG().resourceManager().loadShader("raygen.rgen"),
-    };
-    const auto missShaders = std::array{
-        RG().resourceManager().loadShader("miss.rmiss"),
-        RG().resourceManager().loadShader("shadowMiss.rmiss"),
-    };
-    const auto closestHitShaders = std::array{
-        RG().resourceManager().loadShader("closesthit.rchit"),
+    vk::PipelineLayoutCreateInfo info = {};
+    info.setSetLayoutCount(1);
+    info.setPSetLayouts(&m_descriptorSet.layout());
+
+    m_pipelineLayout = vc.device->createPipelineLayoutUnique(info);
+    vc.setObjectName(*m_pipelineLayout, "Ray Tracer");
+}
+
+Raytracer::Shaders Raytracer::loadShaders() const
+{
+    const auto load = [](const auto& names) {
+        std::vector<std::shared_ptr<gpu::Shader>> shaders;
+        for(const auto& name: names) {
+            shaders.push_back(RG().resourceManager().loadShader(name));
+        }
+        return shaders;
     };
 
+    Shaders shaders;
+    shaders.raygen = load(RAYGEN_SHADERS);
+    shaders.miss = load(MISS_SHADERS);
+    shaders.closestHit = load(CLOSEST_HIT_SHADERS);
+    return shaders;
+}
+
+UniqueRaytracingPipeline Raytracer::createRaytracingPipeline(const Shaders& shaders) const
+{
+    auto result = std::make_unique<RaytracingPipeline>();
+
+    const auto& raygenShaders = shaders.raygen;
+    const auto& missShaders = shaders.miss;
+    const auto& closestHitShaders = shaders.closestHit;
+
     const auto groupSize = utils::alignUp(m_properties.shaderGroupHandleSize, m_properties.shaderGroupBaseAlignment);
     const auto groupStride = groupSize;
 
@@ -269,42 +410,32 @@ void Raytracer::setupRaytracingPipeline()
 
     // raygen group
     {
-        m_raygenSbt.setDeviceAddress(groups.size() * groupSize);
+        result->raygenSbt.setDeviceAddress(groups.size() * groupSize);
         for(const auto& raygenShader: raygenShaders) {
             stages.push_back(raygenShader->shaderStageInfo(vk::ShaderStageFlagBits::eRaygenKHR));
             groups.push_back(generalShaderGroupInfo((uint32_t)groups.size()));
         }
-        m_raygenSbt.setStride(groupStride).setSize(raygenShaders.size() * groupSize);
+        result->raygenSbt.setStride(groupStride).setSize(raygenShaders.size() * groupSize);
     }
 
     // miss group
     {
-        m_missSbt.setDeviceAddress(groups.size() * groupSize);
+        result->missSbt.setDeviceAddress(groups.size() * groupSize);
         for(const auto& missShader: missShaders) {
             stages.push_back(missShader->shaderStageInfo(vk::ShaderStageFlagBits::eMissKHR));
             groups.push_back(generalShaderGroupInfo((uint32_t)groups.size()));
         }
-        m_missSbt.setStride(groupStride).setSize(missShaders.size() * groupSize);
+        result->missSbt.setStride(groupStride).setSize(missShaders.size() * groupSize);
     }
 
     // hit group
     {
-        m_hitSbt.setDeviceAddress(groups.size() * groupSize);
+        result->hitSbt.setDeviceAddress(groups.size() * groupSize);
         for(const auto& closestHitShader: closestHitShaders) {
             stages.push_back(closestHitShader->shaderStageInfo(vk::ShaderStageFlagBits::eClosestHitKHR));
             groups.push_back(closestHitShaderGroupInfo((uint32_t)groups.size()));
         }
-        m_hitSbt.setStride(groupStride).setSize(closestHitShaders.size() * groupSize);
-    }
-
-    // pipeline layout
-    {
-        vk::PipelineLayoutCreateInfo info = {};
-        info.setSetLayoutCount(1);
-        info.setPSetLayouts(&m_descriptorSet.layout());
-
-        m_pipelineLayout = vc.device->createPipelineLayoutUnique(info);
-        vc.setObjectName(*m_pipelineLayout, "Ray Tracer");
+        result->hitSbt.setStride(groupStride).setSize(closestHitShaders.size() * groupSize);
     }
 
     // pipeline
@@ -317,8 +448,13 @@ void Raytracer::setupRaytracingPipeline()
         info.setMaxPipelineRayRecursionDepth(7);
         info.setLayout(*m_pipelineLayout);
 
-        m_pipeline = vc.device->createRayTracingPipelineKHRUnique(nullptr, nullptr, info).value;
-        vc.setObjectName(*m_pipeline, "Ray Tracer");
+        const auto startTime = Clock::now();
+
+        result->pipeline = vc.device->createRayTracingPipelineKHRUnique(nullptr, vc.pipelineCache->cache(), info).value;
+        vc.setObjectName(*result->pipeline, "Ray Tracer");
+
+        const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+        RAYGUN_DEBUG("Ray tracing pipeline created in {:.2f} ms", duration.count());
     }
 
     // shader binding table
@@ -329,16 +465,17 @@ void Raytracer::setupRaytracingPipeline()
         std::vector<uint8_t> groupHandles(groupCount * m_properties.shaderGroupHandleSize);
 
         {
-            const auto result = vc.device->getRayTracingShaderGroupHandlesKHR(*m_pipeline, 0, (uint32_t)groupCount, groupHandles.size(), groupHandles.data());
-            if(result != vk::Result::eSuccess) {
+            const auto handlesResult =
+                vc.device->getRayTracingShaderGroupHandlesKHR(*result->pipeline, 0, (uint32_t)groupCount, groupHandles.size(), groupHandles.data());
+            if(handlesResult != vk::Result::eSuccess) {
                 RAYGUN_FATAL("Unable to get ray tracing shader group handles");
             }
         }
 
-        m_sbtBuffer = std::make_unique<gpu::Buffer>(
+        result->sbtBuffer = std::make_unique<gpu::Buffer>(
             sbtSize, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eShaderBindingTableKHR,
             vk::MemoryPropertyFlagBits::eHostVisible);
-        m_sbtBuffer->setName("Shader Binding Table");
+        result->sbtBuffer->setName("Shader Binding Table");
 
         // Shader group handles should be aligned according to
         // shaderGroupBaseAlignment. The handles we get from
@@ -348,20 +485,22 @@ void Raytracer::setupRaytracingPipeline()
         {
             const auto groupSizeAligned = utils::alignUp(m_properties.shaderGroupHandleSize, m_properties.shaderGroupBaseAlignment);
 
-            auto p = reinterpret_cast<uint8_t*>(m_sbtBuffer->map());
+            auto p = reinterpret_cast<uint8_t*>(result->sbtBuffer->map());
             for(auto i = 0u; i < groupCount; i++) {
                 memcpy(p, groupHandles.data() + i * m_properties.shaderGroupHandleSize, m_properties.shaderGroupHandleSize);
                 p += groupSizeAligned;
             }
 
-            m_sbtBuffer->unmap();
+            result->sbtBuffer->unmap();
         }
 
         // Finally set the correct device address for the shader binding tables.
-        m_raygenSbt.setDeviceAddress(m_sbtBuffer->address() + m_raygenSbt.deviceAddress);
-        m_missSbt.setDeviceAddress(m_sbtBuffer->address() + m_missSbt.deviceAddress);
-        m_hitSbt.setDeviceAddress(m_sbtBuffer->address() + m_hitSbt.deviceAddress);
+        result->raygenSbt.setDeviceAddress(result->sbtBuffer->address() + result->raygenSbt.deviceAddress);
+        result->missSbt.setDeviceAddress(result->sbtBuffer->address() + result->missSbt.deviceAddress);
+        result->hitSbt.setDeviceAddress(result->sbtBuffer->address() + result->hitSbt.deviceAddress);
     }
+
+    return result;
 }
 
 void Raytracer::setupPostprocessing()
@@ -372,6 +511,9 @@ void Raytracer::setupPostprocessing()
     m_roughBlurH = cs.createComputePass("rough_blur_h.comp");
     m_roughBlurV = cs.createComputePass("rough_blur_v.comp");
 
+    m_temporalResolve = cs.createComputePass("temporal_resolve.comp");
+    m_temporalStore = cs.createComputePass("temporal_store.comp");
+
     m_postprocess = cs.createComputePass("postprocess.comp");
     m_fxaa = cs.createComputePass("fxaa.comp");
 }
@@ -380,9 +522,12 @@ const gpu::Image& Raytracer::selectResultImage()
 {
     // For debugging purposes the result image can be selected via ImGui.
 
-    const char* imageNames[] = {"Final", "Base/Temp", "Normal", "Rough", "RTransition", "RCA", "RCB"};
-    gpu::Image* images[] = {m_finalImage.get(),       m_baseImage.get(),    m_normalImage.get(), m_roughImage.get(),
-                            m_roughTransitions.get(), m_roughColorsA.get(), m_roughColorsB.get()};
+    // FXAA writes its result to the base image.
+    gpu::Image* finalImage = m_useFXAA ? m_baseImage.get() : m_finalImage.get();
+
+    const char* imageNames[] = {"Final", "Base/Temp", "Normal", "Rough", "RTransition", "RCA", "RCB", "Temporal"};
+    gpu::Image* images[] = {finalImage,               m_baseImage.get(),    m_normalImage.get(),  m_roughImage.get(),
+                            m_roughTransitions.get(), m_roughColorsA.get(), m_roughColorsB.get(), m_temporalOutput.get()};
     static_assert(RAYGUN_ARRAY_COUNT(imageNames) == RAYGUN_ARRAY_COUNT(images));
 
     static int selectedResult = 0;
@@ -393,10 +538,12 @@ const gpu::Image& Raytracer::selectResultImage()
 
 void Raytracer::initialImageBarrier(vk::CommandBuffer& cmd)
 {
-    const auto images = {m_baseImage.get(),        m_normalImage.get(),  m_roughImage.get(),  m_finalImage.get(),
-                         m_roughTransitions.get(), m_roughColorsA.get(), m_roughColorsB.get()};
+    // History images are not part of this, transitioning them from undefined
+    // layout would discard their content.
+    const auto images = {m_baseImage.get(),        m_normalImage.get(),  m_roughImage.get(),    m_finalImage.get(),
+                         m_roughTransitions.get(), m_roughColorsA.get(), m_roughColorsB.get(), m_temporalOutput.get()};
 
-    std::vector<vk::ImageMemoryBarrier> imageBarriers;
+    utils::ArenaVector<vk::ImageMemoryBarrier> imageBarriers(RG().frameArena());
     imageBarriers.reserve(images.size());
     for(auto& image: images) {
         auto& barrier = imageBarriers.emplace_back();
@@ -412,7 +559,7 @@ void Raytracer::initialImageBarrier(vk::CommandBuffer& cmd)
 
 void Raytracer::computeShaderImageBarrier(vk::CommandBuffer& cmd, std::initializer_list<gpu::Image*> images, vk::PipelineStageFlags srcStageMask)
 {
-    std::vector<vk::ImageMemoryBarrier> imageBarriers;
+    utils::ArenaVector<vk::ImageMemoryBarrier> imageBarriers(RG().frameArena());
     imageBarriers.reserve(images.size());
     for(auto& image: images) {
         auto& barrier = imageBarriers.emplace_back();
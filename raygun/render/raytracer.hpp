@@ -32,6 +32,20 @@
 
 namespace raygun::render {
 
+/// Ray tracing pipeline together with its shader binding table.
+struct RaytracingPipeline {
+    vk::UniquePipeline pipeline;
+
+    gpu::UniqueBuffer sbtBuffer;
+
+    vk::StridedDeviceAddressRegionKHR raygenSbt = {};
+    vk::StridedDeviceAddressRegionKHR missSbt = {};
+    vk::StridedDeviceAddressRegionKHR hitSbt = {};
+    vk::StridedDeviceAddressRegionKHR callableSbt = {};
+};
+
+using UniqueRaytracingPipeline = std::unique_ptr<RaytracingPipeline>;
+
 /// Renderer which is responsible for ray tracing.
 struct Raytracer {
     Raytracer();
@@ -45,12 +59,38 @@ struct Raytracer {
     void updateRenderTarget(const gpu::Buffer& uniformBuffer, const gpu::Buffer& vertexBuffer, const gpu::Buffer& indexBuffer,
                             const gpu::Buffer& materialBuffer);
 
+    /// Adapts the render targets to the given extent. Images are only
+    /// recreated if the extent exceeds their capacity (or is much smaller),
+    /// pipeline and descriptor layouts are kept. Render targets must not be in
+    /// use by the GPU.
+    void resize(vk::Extent2D extent);
+
+    /// Starts rebuilding the ray tracing pipeline in the background if it
+    /// uses one of the given shaders.
+    void reloadShaders(const std::set<string>& changedShaders);
+
+    /// Swaps in a rebuilt pipeline once it is ready. Must be called between
+    /// frames, the old pipeline is retired.
+    void swapPipeline();
+
   private:
     void setupRaytracingImages();
 
     void setupRaytracingDescriptorSet();
 
-    void setupRaytracingPipeline();
+    struct Shaders {
+        std::vector<std::shared_ptr<gpu::Shader>> raygen;
+        std::vector<std::shared_ptr<gpu::Shader>> miss;
+        std::vector<std::shared_ptr<gpu::Shader>> closestHit;
+    };
+
+    Shaders loadShaders() const;
+
+    void setupRaytracingPipelineLayout();
+
+    /// Does not touch the ray tracer's state, can be called from a worker
+    /// thread.
+    UniqueRaytracingPipeline createRaytracingPipeline(const Shaders& shaders) const;
 
     void setupPostprocessing();
 
@@ -63,19 +103,16 @@ struct Raytracer {
 
     vk::PhysicalDeviceRayTracingPipelinePropertiesKHR m_properties = {};
 
-    UniqueTopLevelAS m_topLevelAS;
+    gpu::CompletionToken m_bottomLevelASReady;
 
-    gpu::DescriptorSet m_descriptorSet;
+    TopLevelAS m_topLevelAS;
 
-    vk::StridedDeviceAddressRegionKHR m_raygenSbt = {};
-    vk::StridedDeviceAddressRegionKHR m_missSbt = {};
-    vk::StridedDeviceAddressRegionKHR m_hitSbt = {};
-    vk::StridedDeviceAddressRegionKHR m_callableSbt = {};
+    gpu::DescriptorSet m_descriptorSet;
 
-    vk::UniquePipeline m_pipeline;
     vk::UniquePipelineLayout m_pipelineLayout;
 
-    gpu::UniqueBuffer m_sbtBuffer;
+    UniqueRaytracingPipeline m_pipeline;
+    std::future<UniqueRaytracingPipeline> m_pendingPipeline;
 
     bool m_useFXAA = true;
     compute::UniqueComputePass m_postprocess;
@@ -85,6 +122,13 @@ struct Raytracer {
     compute::UniqueComputePass m_roughBlurH;
     compute::UniqueComputePass m_roughBlurV;
 
+    compute::UniqueComputePass m_temporalResolve;
+    compute::UniqueComputePass m_temporalStore;
+
+    // Render targets are allocated with headroom, only the area given by
+    // vc.windowSize is rendered to.
+    vk::Extent2D m_imageCapacity = {};
+
     // these are rendered to directly in ray tracing
     gpu::UniqueImage m_baseImage;
     gpu::UniqueImage m_normalImage;
@@ -97,6 +141,13 @@ struct Raytracer {
     gpu::UniqueImage m_roughTransitions;
     gpu::UniqueImage m_roughColorsA, m_roughColorsB;
 
+    // temporal accumulation, history is kept across frames
+    gpu::UniqueImage m_historyColor;
+    gpu::UniqueImage m_historyNormal;
+    gpu::UniqueImage m_temporalOutput;
+
+    gpu::CompletionToken m_imagesReady;
+
     VulkanContext& vc;
 };
 
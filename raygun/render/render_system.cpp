@@ -27,6 +27,7 @@
 #include "raygun/logging.hpp"
 #include "raygun/profiler.hpp"
 #include "raygun/raygun.hpp"
+#include "raygun/render/temporal_resolve.hpp"
 
 namespace raygun::render {
 
@@ -42,9 +43,6 @@ RenderSystem::RenderSystem() : vc(RG().vc())
     m_commandBuffer = vc.graphicsQueue->createCommandBuffer();
     vc.setObjectName(*m_commandBuffer, "Render System");
 
-    m_commandBufferFence = vc.device->createFenceUnique({vk::FenceCreateFlagBits::eSignaled});
-    vc.setObjectName(*m_commandBufferFence, "Render System");
-
     m_raytracer = std::make_unique<Raytracer>();
 
     m_imGuiRenderer = std::make_unique<ImGuiRenderer>(*this);
@@ -63,21 +61,42 @@ RenderSystem::~RenderSystem()
     vc.waitIdle();
 }
 
-void RenderSystem::reload()
+void RenderSystem::resize()
 {
-    vc.waitIdle();
+    const auto startTime = Clock::now();
+
+    const auto windowSize = RG().window().size();
+    if(windowSize.width == 0 || windowSize.height == 0) {
+        // Minimized, the swapchain is recreated once the window is restored.
+        return;
+    }
 
-    vc.windowSize = RG().window().size();
+    // Render targets are only used by the frame in flight, the presentation
+    // engine may still hold the old swapchain's images.
+    vc.graphicsQueue->wait(m_frameValue);
+    vc.presentQueue->waitIdle();
+
+    vc.windowSize = windowSize;
 
     RG().scene().camera->updateProjection();
 
-    m_swapchain.reset();
-    m_swapchain = std::make_unique<Swapchain>(*this);
+    m_swapchain->resize();
 
-    m_raytracer.reset();
-    m_raytracer = std::make_unique<Raytracer>();
+    m_raytracer->resize(vc.windowSize);
+
+    // History does not match the new extent.
+    m_resetTemporalHistory = true;
 
-    RAYGUN_INFO("Render System reloaded");
+    const auto duration = std::chrono::duration<double, std::milli>(Clock::now() - startTime);
+    RAYGUN_DEBUG("Render System resized to {}x{} in {:.2f} ms", vc.windowSize.width, vc.windowSize.height, duration.count());
+}
+
+void RenderSystem::reloadShaders(const std::set<string>& changedShaders)
+{
+    RG().computeSystem().reloadShaders(changedShaders);
+    m_raytracer->reloadShaders(changedShaders);
+
+    RAYGUN_INFO("Render System reloading {} shaders", changedShaders.size());
 }
 
 void RenderSystem::preSimulation()
@@ -87,6 +106,12 @@ void RenderSystem::preSimulation()
 
 void RenderSystem::render(Scene& scene)
 {
+    RAYGUN_PROFILE_ZONE("Render");
+
+    // Pipelines rebuilt in the background are swapped in between frames.
+    RG().computeSystem().swapPipelines();
+    m_raytracer->swapPipeline();
+
     beginFrame();
     {
         RG().profiler().resetVulkanQueries(*m_commandBuffer);
@@ -198,6 +223,11 @@ void RenderSystem::setupModelBuffers()
 
     auto [vertexCount, indexCount, materialCount] = getCounts(models, meshes);
 
+    // Previous buffers may still be in use by the frame in flight.
+    retire(std::move(m_vertexBuffer));
+    retire(std::move(m_indexBuffer));
+    retire(std::move(m_materialBuffer));
+
     m_vertexBuffer = std::make_unique<gpu::Buffer>(vertexCount * sizeof(Vertex),
                                                    vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer
                                                        | vk::BufferUsageFlagBits::eShaderDeviceAddress
@@ -241,14 +271,24 @@ void RenderSystem::resetUniformBuffer()
     ubo.lightDir = glm::normalize(vec3(.4f, -.6f, -.8f));
     ubo.numSamples = 1;
     ubo.maxRecursions = 5;
+    ubo.temporal = true;
+    ubo.temporalAlpha = 0.1f;
+
+    m_resetTemporalHistory = true;
 }
 
 void RenderSystem::updateUniformBuffer(const Camera& camera)
 {
     auto& ubo = *static_cast<gpu::UniformBufferObject*>(m_uniformBuffer->map());
-    ubo.viewInverse = camera.viewInverse();
+
+    // Keep last frame's camera for reprojection.
+    ubo.prevViewInverse = ubo.viewInverse;
+    ubo.prevViewProj = glm::inverse(ubo.projInverse) * glm::inverse(ubo.viewInverse);
+
+    ubo.viewInverse = camera.viewInverse(RG().interpolationFactor());
     ubo.projInverse = camera.projInverse();
     ubo.clearColor = vec3{0.2f, 0.2f, 0.2f};
+    ubo.renderSize = vec2((float)vc.windowSize.width, (float)vc.windowSize.height);
 
     // Loop shader time to keep float quality up while also smoothly animating
     // everything which uses trigonometry animation.
@@ -260,11 +300,27 @@ void RenderSystem::updateUniformBuffer(const Camera& camera)
     }
 
     // UI
-    ImGui::SliderInt("SSAA samples", &ubo.numSamples, 1, 32);
+    if(ImGui::Checkbox("Temporal accumulation", &ubo.temporal)) {
+        m_resetTemporalHistory = true;
+    }
+    if(ubo.temporal) {
+        ImGui::SliderFloat("Temporal alpha", &ubo.temporalAlpha, 0.01f, 1.0f);
+    }
+    else {
+        ImGui::SliderInt("SSAA samples", &ubo.numSamples, 1, 32);
+    }
     ImGui::SliderInt("Max recursions", &ubo.maxRecursions, 0, 7);
-    auto lightLabel = fmt::format("Light Dir {} ###lightdir", ubo.lightDir);
+    utils::ArenaString lightLabel(RG().frameArena());
+    fmt::format_to(std::back_inserter(lightLabel), "Light Dir {} ###lightdir", ubo.lightDir);
     ImGui::gizmo3D(lightLabel.c_str(), ubo.lightDir);
     ImGui::Checkbox("Show Alpha", &ubo.showAlpha);
+
+    // Temporal accumulation, frame index 0 discards the history.
+    if(ubo.temporal) {
+        ubo.frameIndex = m_resetTemporalHistory ? 0 : ubo.frameIndex + 1;
+        ubo.jitter = temporalJitter(ubo.frameIndex);
+        m_resetTemporalHistory = false;
+    }
 }
 
 void RenderSystem::updateVertexAndIndexBuffer(std::set<Mesh*>& meshes)
@@ -331,33 +387,37 @@ void RenderSystem::updateMaterialBuffer(std::vector<Model*>& models)
 
 void RenderSystem::beginFrame()
 {
+    RAYGUN_PROFILE_ZONE("Begin Frame");
+
     m_framebufferIndex = m_swapchain->nextImageIndex(*m_imageAcquiredSemaphore);
 
     // Ensure command buffer is ready to use.
-    vc.waitForFence(*m_commandBufferFence);
+    vc.graphicsQueue->wait(m_frameValue);
 
-    vc.device->resetFences(*m_commandBufferFence);
+    // Releases resources retired up to the previous frame.
+    vc.runCompletedCallbacks();
 
     m_commandBuffer->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
 }
 
-void RenderSystem::endFrame(std::vector<vk::Semaphore> waitSemaphores)
+void RenderSystem::endFrame(vk::ArrayProxy<const vk::Semaphore> additionalWaitSemaphores)
 {
-    waitSemaphores.push_back(*m_imageAcquiredSemaphore);
-    std::vector<vk::PipelineStageFlags> pipeStageFlags(waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands);
+    RAYGUN_PROFILE_ZONE("Submit");
 
-    vk::SubmitInfo submitInfo = {};
-    submitInfo.setWaitSemaphoreCount((uint32_t)waitSemaphores.size());
-    submitInfo.setPWaitSemaphores(waitSemaphores.data());
-    submitInfo.setPWaitDstStageMask(pipeStageFlags.data());
-    submitInfo.setCommandBufferCount(1);
-    submitInfo.setPCommandBuffers(&*m_commandBuffer);
-    submitInfo.setSignalSemaphoreCount(1);
-    submitInfo.setPSignalSemaphores(&*m_renderCompleteSemaphore);
+    auto& arena = RG().frameArena();
+
+    utils::ArenaVector<vk::Semaphore> waitSemaphores(additionalWaitSemaphores.begin(), additionalWaitSemaphores.end(), arena);
+    waitSemaphores.push_back(*m_imageAcquiredSemaphore);
+    utils::ArenaVector<vk::PipelineStageFlags> pipeStageFlags(waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands, arena);
 
     m_commandBuffer->end();
 
-    vc.graphicsQueue->submit(submitInfo, *m_commandBufferFence);
+    m_frameValue = vc.graphicsQueue->submit(*m_commandBuffer, waitSemaphores, pipeStageFlags, *m_renderCompleteSemaphore);
+
+    if(!m_retiredResources.empty()) {
+        vc.graphicsQueue->retire(m_frameValue, std::move(m_retiredResources));
+        m_retiredResources.clear();
+    }
 }
 
 void RenderSystem::beginRenderPass()
@@ -377,6 +437,8 @@ void RenderSystem::endRenderPass()
 
 void RenderSystem::presentFrame()
 {
+    RAYGUN_PROFILE_ZONE("Present");
+
     vk::PresentInfoKHR presentInfo = {};
     presentInfo.setWaitSemaphoreCount(1);
     presentInfo.setPWaitSemaphores(&*m_renderCompleteSemaphore);
@@ -385,11 +447,11 @@ void RenderSystem::presentFrame()
     presentInfo.setPImageIndices(&m_framebufferIndex);
 
     try {
-        (void)vc.presentQueue->queue().presentKHR(presentInfo);
+        (void)vc.presentQueue->present(presentInfo);
     }
     catch(const vk::OutOfDateKHRError&) {
         RAYGUN_DEBUG("Swap chain out of date");
-        reload();
+        resize();
     }
 }
 
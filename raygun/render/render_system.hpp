@@ -45,7 +45,22 @@ class RenderSystem {
     RenderSystem();
     ~RenderSystem();
 
-    void reload();
+    /// Adapts to a new window size. Only the swapchain is recreated, the ray
+    /// tracer keeps its pipelines and reuses render targets where possible.
+    void resize();
+
+    /// Rebuilds only the pipelines using one of the given shaders. Rebuilt
+    /// pipelines are swapped in at the beginning of a later frame.
+    void reloadShaders(const std::set<string>& changedShaders);
+
+    /// Keeps the given resource alive until the GPU has passed the next frame.
+    /// This covers resources used by the frame in flight as well as by the
+    /// frame currently being recorded.
+    template<typename T>
+    void retire(T resource)
+    {
+        m_retiredResources.push_back(std::make_shared<T>(std::move(resource)));
+    }
 
     void preSimulation();
 
@@ -78,7 +93,14 @@ class RenderSystem {
     UniqueSwapchain m_swapchain;
 
     vk::UniqueCommandBuffer m_commandBuffer;
-    vk::UniqueFence m_commandBufferFence;
+
+    /// Graphics queue timeline value of the latest frame.
+    ///
+    /// There is a single frame in flight: beginFrame waits for this value
+    /// before recording. Per-frame host-visible resources (uniform buffer,
+    /// TLAS instance buffers) are overwritten in place and rely on this;
+    /// they need one copy per frame before more frames may be in flight.
+    uint64_t m_frameValue = 0;
 
     UniqueRaytracer m_raytracer;
 
@@ -98,12 +120,16 @@ class RenderSystem {
 
     std::unique_ptr<Fade> m_currentFade;
 
+    std::vector<std::shared_ptr<void>> m_retiredResources;
+
+    bool m_resetTemporalHistory = true;
+
     void updateUniformBuffer(const Camera& camera);
     void updateVertexAndIndexBuffer(std::set<Mesh*>& meshes);
     void updateMaterialBuffer(std::vector<Model*>& models);
 
     void beginFrame();
-    void endFrame(std::vector<vk::Semaphore> waitSemaphores = {});
+    void endFrame(vk::ArrayProxy<const vk::Semaphore> additionalWaitSemaphores = {});
 
     void beginRenderPass();
     void endRenderPass();
@@ -45,6 +45,22 @@ uint32_t Swapchain::nextImageIndex(vk::Semaphore imageAcquiredSemaphore)
     return vc.device->acquireNextImageKHR(*m_swapchain, UINT64_MAX, imageAcquiredSemaphore, nullptr).value;
 }
 
+void Swapchain::resize()
+{
+    // Views and framebuffers reference the old swapchain's images, which are
+    // released together with the old swapchain.
+    m_framebuffers.clear();
+    m_imageViews.clear();
+
+    setupSwapchain();
+
+    setupImages();
+
+    setupImageViews();
+
+    setupFramebuffers();
+}
+
 void Swapchain::setupSwapchain()
 {
     const auto capabilities = vc.physicalDevice.getSurfaceCapabilitiesKHR(*vc.surface);
@@ -34,6 +34,10 @@ class Swapchain {
 
     uint32_t nextImageIndex(vk::Semaphore imageAcquiredSemaphore);
 
+    /// Recreates the swapchain for the current window size. The old swapchain
+    /// is handed to the driver for reuse, the render pass stays valid.
+    void resize();
+
     uint32_t imageCount() const { return (uint32_t)m_images.size(); }
 
     vk::SwapchainKHR& swapchain() { return *m_swapchain; }
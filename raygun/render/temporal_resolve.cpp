@@ -0,0 +1,52 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/render/temporal_resolve.hpp"
+
+#include "resources/shaders/temporal_shared.def"
+
+namespace raygun::render {
+
+namespace {
+
+    float halton(int index, int base)
+    {
+        auto f = 1.0f;
+        auto result = 0.0f;
+        while(index > 0) {
+            f /= (float)base;
+            result += f * (float)(index % base);
+            index /= base;
+        }
+        return result;
+    }
+
+} // namespace
+
+vec2 temporalJitter(int frameIndex)
+{
+    const auto index = frameIndex % TEMPORAL_JITTER_SAMPLES + 1;
+    return vec2(halton(index, 2), halton(index, 3)) - 0.5f;
+}
+
+} // namespace raygun::render
@@ -22,6 +22,7 @@
 
 #include "raygun/resource_manager.hpp"
 
+#include "raygun/config.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/utils/assimp_utils.hpp"
 
@@ -57,6 +58,11 @@ namespace {
     }
 } // namespace
 
+ResourceManager::ResourceManager()
+{
+    m_shaderCompiler = std::make_unique<gpu::ShaderCompiler>(RESOURCES_DIR / "shaders", configDirectory() / "shader_cache");
+}
+
 std::shared_ptr<Material> ResourceManager::loadMaterial(string_view nameView)
 {
     const auto name = string{nameView};
@@ -77,11 +83,18 @@ std::vector<render::Model*> ResourceManager::models()
     return result;
 }
 
-void ResourceManager::clearUnusedModelsAndMaterials()
+std::vector<std::shared_ptr<render::Model>> ResourceManager::clearUnusedModelsAndMaterials()
 {
-    std::experimental::erase_if(m_loadedModels, [](const auto& sptr) { return sptr.use_count() <= 1; });
+    std::vector<std::shared_ptr<render::Model>> removedModels;
+    std::experimental::erase_if(m_loadedModels, [&](const auto& sptr) {
+        if(sptr.use_count() > 1) return false;
+        removedModels.push_back(sptr);
+        return true;
+    });
 
     std::experimental::erase_if(m_materialCache, [](const auto& pair) { return pair.second.use_count() <= 1; });
+
+    return removedModels;
 }
 
 std::vector<Material*> ResourceManager::materials()
@@ -104,6 +117,18 @@ void ResourceManager::clearShaderCache()
     m_shaderCache.clear();
 }
 
+void ResourceManager::clearShaderCache(const std::set<string>& names)
+{
+    std::experimental::erase_if(m_shaderCache, [&](const auto& pair) { return names.count(pair.first) > 0; });
+}
+
+std::set<string> ResourceManager::recompileShaders()
+{
+    auto changed = m_shaderCompiler->compileChanged();
+    clearShaderCache(changed);
+    return changed;
+}
+
 std::shared_ptr<ui::Font> ResourceManager::loadFont(string_view nameView)
 {
     const auto name = string{nameView};
@@ -25,6 +25,7 @@
 #include "raygun/audio/sound.hpp"
 #include "raygun/entity.hpp"
 #include "raygun/gpu/shader.hpp"
+#include "raygun/gpu/shader_compiler.hpp"
 #include "raygun/material.hpp"
 #include "raygun/render/model.hpp"
 #include "raygun/ui/text.hpp"
@@ -34,6 +35,8 @@ namespace raygun {
 /// A resource manager that caches resources on load.
 class ResourceManager {
   public:
+    ResourceManager();
+
     /// Convenience function for loading entities.
     template<typename T = Entity>
     std::shared_ptr<T> loadEntity(string_view name)
@@ -49,7 +52,8 @@ class ResourceManager {
     /// Returns a list of all registered models.
     std::vector<render::Model*> models();
 
-    void clearUnusedModelsAndMaterials();
+    /// Returns the removed models, their GPU resources may still be in use.
+    std::vector<std::shared_ptr<render::Model>> clearUnusedModelsAndMaterials();
 
     std::shared_ptr<Material> loadMaterial(string_view name);
 
@@ -60,6 +64,13 @@ class ResourceManager {
 
     void clearShaderCache();
 
+    /// Removes only the given shaders from the cache.
+    void clearShaderCache(const std::set<string>& names);
+
+    /// Compiles shaders whose sources changed and evicts them from the cache.
+    /// Returns the names of the updated shaders.
+    std::set<string> recompileShaders();
+
     std::shared_ptr<ui::Font> loadFont(string_view name);
 
     std::shared_ptr<audio::Sound> loadSound(string_view name);
@@ -73,6 +84,8 @@ class ResourceManager {
 
     std::map<string, std::shared_ptr<gpu::Shader>> m_shaderCache;
 
+    gpu::UniqueShaderCompiler m_shaderCompiler;
+
     std::map<string, std::shared_ptr<ui::Font>> m_fontCache;
 
     std::map<string, std::shared_ptr<audio::Sound>> m_soundCache;
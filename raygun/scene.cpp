@@ -28,8 +28,47 @@ namespace raygun {
 
 Scene::Scene() : pxScene(RG().physicsSystem().createScene())
 {
+    root->setScene(this);
+
     camera = std::make_shared<Camera>();
     root->addChild(camera);
 }
 
+Scene::~Scene()
+{
+    // Entities may outlive the scene.
+    root->setScene(nullptr);
+}
+
+void Scene::addPhysicsActor(physx::PxActor& actor)
+{
+    m_pendingPhysicsActors.push_back(&actor);
+}
+
+void Scene::removePhysicsActor(physx::PxActor& actor)
+{
+    // Buffered events must not refer to the actor after its release.
+    RG().physicsSystem().dropEvents(actor);
+
+    const auto it = std::find(m_pendingPhysicsActors.begin(), m_pendingPhysicsActors.end(), &actor);
+    if(it != m_pendingPhysicsActors.end()) {
+        *it = m_pendingPhysicsActors.back();
+        m_pendingPhysicsActors.pop_back();
+        return;
+    }
+
+    // PhysX buffers removals during simulation.
+    if(actor.getScene() == pxScene.get()) {
+        pxScene->removeActor(actor);
+    }
+}
+
+void Scene::flushPhysicsActors()
+{
+    if(m_pendingPhysicsActors.empty()) return;
+
+    pxScene->addActors(m_pendingPhysicsActors.data(), (physx::PxU32)m_pendingPhysicsActors.size());
+    m_pendingPhysicsActors.clear();
+}
+
 } // namespace raygun
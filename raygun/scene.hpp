@@ -35,7 +35,7 @@ class Raygun;
 
 struct Scene {
     Scene();
-    virtual ~Scene() {}
+    virtual ~Scene();
 
     std::shared_ptr<Camera> camera;
 
@@ -49,6 +49,24 @@ struct Scene {
 
     /// This function is called every simulation sub-step.
     virtual void update([[maybe_unused]] double timeDelta) {}
+
+    /// Physics actors of entities attached to the scene are queued and added
+    /// to pxScene in one batch by flushPhysicsActors. Called by Entity.
+    void addPhysicsActor(physx::PxActor& actor);
+    void removePhysicsActor(physx::PxActor& actor);
+
+    /// Adds queued physics actors to pxScene.
+    void flushPhysicsActors();
+
+    /// True while Raygun runs a simulation step for this scene.
+    bool inSimulationStep() const { return m_inSimulationStep; }
+
+  private:
+    friend class Raygun;
+
+    bool m_inSimulationStep = false;
+
+    std::vector<physx::PxActor*> m_pendingPhysicsActors;
 };
 
 using UniqueScene = std::unique_ptr<Scene>;
@@ -111,7 +111,7 @@ static inline Transform interpolate(const Transform& x, const Transform& y, floa
 
     Transform result;
     result.position = glm::lerp(x.position, y.position, factor);
-    result.rotation = glm::lerp(x.rotation, y.rotation, factor);
+    result.rotation = glm::slerp(x.rotation, y.rotation, factor);
     result.scaling = glm::lerp(x.scaling, y.scaling, factor);
     return result;
 }
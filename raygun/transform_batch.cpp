@@ -0,0 +1,328 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include "raygun/transform_batch.hpp"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define RAYGUN_TRANSFORM_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define RAYGUN_TRANSFORM_BATCH_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define RAYGUN_TRANSFORM_BATCH_NEON
+#endif
+
+namespace raygun {
+
+namespace {
+
+#if defined(RAYGUN_TRANSFORM_BATCH_AVX2)
+    constexpr size_t LANES = 8;
+    constexpr auto ISA = "AVX2";
+
+    struct Lanes {
+        __m256 v;
+    };
+
+    inline Lanes load(const float* p) { return {_mm256_load_ps(p)}; }
+    inline void store(float* p, Lanes a) { _mm256_store_ps(p, a.v); }
+    inline Lanes splat(float f) { return {_mm256_set1_ps(f)}; }
+    inline Lanes operator+(Lanes a, Lanes b) { return {_mm256_add_ps(a.v, b.v)}; }
+    inline Lanes operator-(Lanes a, Lanes b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    inline Lanes operator*(Lanes a, Lanes b) { return {_mm256_mul_ps(a.v, b.v)}; }
+#elif defined(RAYGUN_TRANSFORM_BATCH_SSE2)
+    constexpr size_t LANES = 4;
+    constexpr auto ISA = "SSE2";
+
+    struct Lanes {
+        __m128 v;
+    };
+
+    inline Lanes load(const float* p) { return {_mm_load_ps(p)}; }
+    inline void store(float* p, Lanes a) { _mm_store_ps(p, a.v); }
+    inline Lanes splat(float f) { return {_mm_set1_ps(f)}; }
+    inline Lanes operator+(Lanes a, Lanes b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline Lanes operator-(Lanes a, Lanes b) { return {_mm_sub_ps(a.v, b.v)}; }
+    inline Lanes operator*(Lanes a, Lanes b) { return {_mm_mul_ps(a.v, b.v)}; }
+#elif defined(RAYGUN_TRANSFORM_BATCH_NEON)
+    constexpr size_t LANES = 4;
+    constexpr auto ISA = "NEON";
+
+    struct Lanes {
+        float32x4_t v;
+    };
+
+    inline Lanes load(const float* p) { return {vld1q_f32(p)}; }
+    inline void store(float* p, Lanes a) { vst1q_f32(p, a.v); }
+    inline Lanes splat(float f) { return {vdupq_n_f32(f)}; }
+    inline Lanes operator+(Lanes a, Lanes b) { return {vaddq_f32(a.v, b.v)}; }
+    inline Lanes operator-(Lanes a, Lanes b) { return {vsubq_f32(a.v, b.v)}; }
+    inline Lanes operator*(Lanes a, Lanes b) { return {vmulq_f32(a.v, b.v)}; }
+#else
+    constexpr size_t LANES = 4;
+    constexpr auto ISA = "scalar";
+
+    // Plain floats, left to the auto-vectorizer.
+    struct Lanes {
+        float v[LANES];
+    };
+
+    inline Lanes load(const float* p)
+    {
+        Lanes r;
+        for(size_t i = 0; i < LANES; ++i) {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+
+    inline void store(float* p, Lanes a)
+    {
+        for(size_t i = 0; i < LANES; ++i) {
+            p[i] = a.v[i];
+        }
+    }
+
+    inline Lanes splat(float f) { return {{f, f, f, f}}; }
+
+    inline Lanes operator+(Lanes a, Lanes b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    inline Lanes operator-(Lanes a, Lanes b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+    inline Lanes operator*(Lanes a, Lanes b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+#endif
+
+    struct Vec3Lanes {
+        Lanes x, y, z;
+    };
+
+    struct QuatLanes {
+        Lanes x, y, z, w;
+    };
+
+    struct TransformLanes {
+        Vec3Lanes position;
+        QuatLanes rotation;
+        Vec3Lanes scaling;
+    };
+
+    /// Structure of arrays staging area for one block of transforms.
+    struct alignas(32) TransformBlock {
+        static constexpr size_t COMPONENTS = 10;
+        float data[COMPONENTS][LANES];
+
+        /// Unused lanes are filled with identity transforms.
+        void gather(const Transform* transforms, size_t count)
+        {
+            for(size_t i = 0; i < LANES; ++i) {
+                const auto& t = i < count ? transforms[i] : Transform{};
+                data[0][i] = t.position.x;
+                data[1][i] = t.position.y;
+                data[2][i] = t.position.z;
+                data[3][i] = t.rotation.x;
+                data[4][i] = t.rotation.y;
+                data[5][i] = t.rotation.z;
+                data[6][i] = t.rotation.w;
+                data[7][i] = t.scaling.x;
+                data[8][i] = t.scaling.y;
+                data[9][i] = t.scaling.z;
+            }
+        }
+
+        void scatter(Transform* transforms, size_t count) const
+        {
+            for(size_t i = 0; i < count; ++i) {
+                auto& t = transforms[i];
+                t.position = {data[0][i], data[1][i], data[2][i]};
+                t.rotation.x = data[3][i];
+                t.rotation.y = data[4][i];
+                t.rotation.z = data[5][i];
+                t.rotation.w = data[6][i];
+                t.scaling = {data[7][i], data[8][i], data[9][i]};
+            }
+        }
+
+        TransformLanes load() const
+        {
+            return {
+                {::raygun::load(data[0]), ::raygun::load(data[1]), ::raygun::load(data[2])},
+                {::raygun::load(data[3]), ::raygun::load(data[4]), ::raygun::load(data[5]), ::raygun::load(data[6])},
+                {::raygun::load(data[7]), ::raygun::load(data[8]), ::raygun::load(data[9])},
+            };
+        }
+
+        void store(const TransformLanes& t)
+        {
+            ::raygun::store(data[0], t.position.x);
+            ::raygun::store(data[1], t.position.y);
+            ::raygun::store(data[2], t.position.z);
+            ::raygun::store(data[3], t.rotation.x);
+            ::raygun::store(data[4], t.rotation.y);
+            ::raygun::store(data[5], t.rotation.z);
+            ::raygun::store(data[6], t.rotation.w);
+            ::raygun::store(data[7], t.scaling.x);
+            ::raygun::store(data[8], t.scaling.y);
+            ::raygun::store(data[9], t.scaling.z);
+        }
+    };
+
+    inline Vec3Lanes cross(const Vec3Lanes& a, const Vec3Lanes& b)
+    {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    /// Same as glm::rotate(q, v).
+    inline Vec3Lanes rotate(const QuatLanes& q, const Vec3Lanes& v)
+    {
+        const Vec3Lanes qv = {q.x, q.y, q.z};
+        const auto uv = cross(qv, v);
+        const auto uuv = cross(qv, uv);
+
+        const auto two = splat(2.0f);
+        return {v.x + (uv.x * q.w + uuv.x) * two, v.y + (uv.y * q.w + uuv.y) * two, v.z + (uv.z * q.w + uuv.z) * two};
+    }
+
+    /// Same as quat operator*.
+    inline QuatLanes multiply(const QuatLanes& p, const QuatLanes& q)
+    {
+        return {
+            p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+            p.w * q.y + p.y * q.w + p.z * q.x - p.x * q.z,
+            p.w * q.z + p.z * q.w + p.x * q.y - p.y * q.x,
+            p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z,
+        };
+    }
+
+    /// Same as Transform operator*.
+    inline TransformLanes compose(const TransformLanes& x, const TransformLanes& y)
+    {
+        const Vec3Lanes scaled = {x.scaling.x * y.position.x, x.scaling.y * y.position.y, x.scaling.z * y.position.z};
+        const auto rotated = rotate(x.rotation, scaled);
+
+        return {
+            {rotated.x + x.position.x, rotated.y + x.position.y, rotated.z + x.position.z},
+            multiply(x.rotation, y.rotation),
+            {x.scaling.x * y.scaling.x, x.scaling.y * y.scaling.y, x.scaling.z * y.scaling.z},
+        };
+    }
+
+    /// Rows of the 3x4 affine matrix T * R * S, as in Transform::toMat4.
+    inline void toMatrix(const TransformLanes& t, Lanes (&rows)[3][4])
+    {
+        const auto& q = t.rotation;
+        const auto one = splat(1.0f);
+        const auto two = splat(2.0f);
+
+        const auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const auto wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        rows[0][0] = (one - two * (yy + zz)) * t.scaling.x;
+        rows[0][1] = two * (xy - wz) * t.scaling.y;
+        rows[0][2] = two * (xz + wy) * t.scaling.z;
+        rows[0][3] = t.position.x;
+
+        rows[1][0] = two * (xy + wz) * t.scaling.x;
+        rows[1][1] = (one - two * (xx + zz)) * t.scaling.y;
+        rows[1][2] = two * (yz - wx) * t.scaling.z;
+        rows[1][3] = t.position.y;
+
+        rows[2][0] = two * (xz - wy) * t.scaling.x;
+        rows[2][1] = two * (yz + wx) * t.scaling.y;
+        rows[2][2] = (one - two * (xx + yy)) * t.scaling.z;
+        rows[2][3] = t.position.z;
+    }
+
+    /// Writes matrices of the first n lanes, starting at index first.
+    void writeMatrices(const TransformLanes& transforms, float* out, size_t outStride, size_t first, size_t n)
+    {
+        Lanes rows[3][4];
+        toMatrix(transforms, rows);
+
+        alignas(32) float matrices[3][4][LANES];
+        for(size_t r = 0; r < 3; ++r) {
+            for(size_t c = 0; c < 4; ++c) {
+                store(matrices[r][c], rows[r][c]);
+            }
+        }
+
+        for(size_t i = 0; i < n; ++i) {
+            auto matrix = reinterpret_cast<float*>(reinterpret_cast<char*>(out) + (first + i) * outStride);
+            for(size_t r = 0; r < 3; ++r) {
+                for(size_t c = 0; c < 4; ++c) {
+                    matrix[r * 4 + c] = matrices[r][c][i];
+                }
+            }
+        }
+    }
+
+} // namespace
+
+void composeTransforms(const Transform* parents, const Transform* locals, Transform* out, size_t count)
+{
+    TransformBlock parentBlock, localBlock;
+
+    for(size_t first = 0; first < count; first += LANES) {
+        const auto n = std::min(LANES, count - first);
+
+        parentBlock.gather(parents + first, n);
+        localBlock.gather(locals + first, n);
+
+        localBlock.store(compose(parentBlock.load(), localBlock.load()));
+        localBlock.scatter(out + first, n);
+    }
+}
+
+void composeMatrices(const Transform* parents, const Transform* locals, float* out, size_t outStride, size_t count)
+{
+    TransformBlock parentBlock, localBlock;
+
+    for(size_t first = 0; first < count; first += LANES) {
+        const auto n = std::min(LANES, count - first);
+
+        parentBlock.gather(parents + first, n);
+        localBlock.gather(locals + first, n);
+
+        writeMatrices(compose(parentBlock.load(), localBlock.load()), out, outStride, first, n);
+    }
+}
+
+void toMatrices(const Transform* transforms, float* out, size_t outStride, size_t count)
+{
+    TransformBlock block;
+
+    for(size_t first = 0; first < count; first += LANES) {
+        const auto n = std::min(LANES, count - first);
+
+        block.gather(transforms + first, n);
+
+        writeMatrices(block.load(), out, outStride, first, n);
+    }
+}
+
+const char* transformBatchIsa()
+{
+    return ISA;
+}
+
+} // namespace raygun
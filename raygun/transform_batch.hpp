@@ -0,0 +1,49 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "raygun/transform.hpp"
+
+namespace raygun {
+
+/// Batched Transform kernels, processing several transforms at once using
+/// SIMD (AVX2 when enabled at compile time, SSE2, NEON) or a scalar fallback.
+/// Results match the scalar Transform functions within floating point
+/// rounding.
+
+/// out[i] = parents[i] * locals[i]. out may alias locals.
+void composeTransforms(const Transform* parents, const Transform* locals, Transform* out, size_t count);
+
+/// Writes glm::transpose((parents[i] * locals[i]).toMat4()) as 3x4 row-major
+/// matrix (VkTransformMatrixKHR layout) to out, advancing by outStride bytes
+/// per matrix. This allows writing into arrays of larger structs directly.
+void composeMatrices(const Transform* parents, const Transform* locals, float* out, size_t outStride, size_t count);
+
+/// Same as composeMatrices, but without composition.
+void toMatrices(const Transform* transforms, float* out, size_t outStride, size_t count);
+
+/// Name of the instruction set used by the batch kernels.
+const char* transformBatchIsa();
+
+} // namespace raygun
@@ -636,6 +636,8 @@ void Slider::setSmooth(bool smoothVal)
 
 bool runUI(Entity& root, double deltatime, input::Input input)
 {
+    RAYGUN_PROFILE_ZONE("UI");
+
     bool consumed = false;
     root.forEachEntity([&](Entity& ent) {
         if(auto s = dynamic_cast<SelectableWidget*>(&ent)) {
@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+namespace raygun::utils {
+
+/// Linear allocator for transient data. Allocations bump a pointer and are
+/// released all at once by reset.
+///
+/// If an allocation does not fit, an additional block is allocated. On the
+/// next reset all blocks are merged into one covering the previous peak, so
+/// that the arena stops touching the heap once it has warmed up.
+class Arena {
+  public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE) { addBlock(blockSize); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment)
+    {
+        auto* block = &m_blocks.back();
+
+        auto offset = alignedOffset(*block, alignment);
+        if(offset + size > block->size) {
+            block = &addBlock(std::max(m_blocks.front().size, size + alignment));
+            offset = alignedOffset(*block, alignment);
+        }
+
+        block->used = offset + size;
+        return block->data.get() + offset;
+    }
+
+    void reset()
+    {
+        m_peakBytes = std::max(m_peakBytes, bytesUsed());
+
+        if(m_blocks.size() > 1) {
+            size_t totalSize = 0;
+            for(const auto& block: m_blocks) {
+                totalSize += block.size;
+            }
+
+            m_blocks.clear();
+            addBlock(totalSize);
+        }
+
+        m_blocks.back().used = 0;
+    }
+
+    size_t bytesUsed() const
+    {
+        size_t used = 0;
+        for(const auto& block: m_blocks) {
+            used += block.used;
+        }
+        return used;
+    }
+
+    size_t peakBytes() const { return std::max(m_peakBytes, bytesUsed()); }
+
+    /// Number of blocks allocated from the heap so far. Constant in steady
+    /// state.
+    size_t blockAllocations() const { return m_blockAllocations; }
+
+  private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+        size_t used = 0;
+    };
+
+    std::vector<Block> m_blocks;
+
+    size_t m_peakBytes = 0;
+    size_t m_blockAllocations = 0;
+
+    Block& addBlock(size_t size)
+    {
+        ++m_blockAllocations;
+        return m_blocks.emplace_back(Block{std::make_unique<std::byte[]>(size), size, 0});
+    }
+
+    static size_t alignedOffset(const Block& block, size_t alignment)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(block.data.get()) + block.used;
+        return block.used + (alignment - address % alignment) % alignment;
+    }
+};
+
+/// STL allocator adapter for Arena. Deallocation is a no-op, memory is
+/// reclaimed when the arena is reset.
+template<typename T>
+class ArenaAllocator {
+  public:
+    using value_type = T;
+
+    ArenaAllocator(Arena& arena) noexcept : m_arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena())
+    {
+    }
+
+    T* allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    Arena* arena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return m_arena == other.arena();
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return m_arena != other.arena();
+    }
+
+  private:
+    Arena* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+} // namespace raygun::utils
@@ -0,0 +1,64 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019-2021 The Raygun Authors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#pragma once
+
+namespace raygun::utils {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+/// 64 bit FNV-1a hash, pass a previous result as seed to chain calls.
+static inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = FNV_OFFSET_BASIS)
+{
+    auto hash = seed;
+    const auto bytes = static_cast<const uint8_t*>(data);
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static inline uint64_t hashString(string_view str, uint64_t seed = FNV_OFFSET_BASIS)
+{
+    // Include the size so consecutive strings cannot shift into each other.
+    const auto size = (uint64_t)str.size();
+    return hashBytes(str.data(), str.size(), hashBytes(&size, sizeof(size), seed));
+}
+
+template<typename T>
+static inline uint64_t hashValue(const T& value, uint64_t seed = FNV_OFFSET_BASIS)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    return hashBytes(&value, sizeof(value), seed);
+}
+
+template<typename T>
+static inline uint64_t hashVector(const std::vector<T>& values, uint64_t seed = FNV_OFFSET_BASIS)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    return hashBytes(values.data(), values.size() * sizeof(T), hashValue((uint64_t)values.size(), seed));
+}
+
+} // namespace raygun::utils
@@ -25,6 +25,15 @@
 #define RAYGUN_XSTR(x) RAYGUN_STR(x)
 #define RAYGUN_STR(x) #x
 
+#define RAYGUN_CONCAT(a, b) RAYGUN_CONCAT_IMPL(a, b)
+#define RAYGUN_CONCAT_IMPL(a, b) a##b
+
+#ifdef _MSC_VER
+    #define RAYGUN_FUNCTION_NAME __FUNCSIG__
+#else
+    #define RAYGUN_FUNCTION_NAME __PRETTY_FUNCTION__
+#endif
+
 #define RAYGUN_MAKE_VERSION(major, minor, patch) "v" RAYGUN_XSTR(major) "." RAYGUN_XSTR(minor) "." RAYGUN_XSTR(patch)
 
 #ifdef NDEBUG
@@ -22,28 +22,8 @@
 
 #pragma once
 
-#include "raygun/logging.hpp"
+#include "raygun/profiler_zones.hpp"
 
-#define RAYGUN_TIME_SCOPE const ::raygun::ScopedTimer _raygunScopedTimer(__FUNCSIG__ ":" RAYGUN_XSTR(__LINE__))
-
-namespace raygun {
-
-/// A basic logging utility to time a certain scope.
-class ScopedTimer {
-  public:
-    ScopedTimer(string_view label) : m_label(label) {}
-
-    ~ScopedTimer()
-    {
-        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
-
-        RAYGUN_INFO("{}: {} ms", m_label, duration.count());
-    }
-
-  private:
-    string m_label;
-
-    Clock::time_point start = Clock::now();
-};
-
-} // namespace raygun
+/// Times the enclosing scope as a CPU zone named after the function, shown
+/// in the profiler and trace exports.
+#define RAYGUN_TIME_SCOPE RAYGUN_PROFILE_ZONE(RAYGUN_FUNCTION_NAME)
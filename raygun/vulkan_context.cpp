@@ -23,6 +23,7 @@
 #include "raygun/vulkan_context.hpp"
 
 #include "raygun/assert.hpp"
+#include "raygun/config.hpp"
 #include "raygun/info.hpp"
 #include "raygun/logging.hpp"
 #include "raygun/raygun.hpp"
@@ -33,16 +34,18 @@ namespace raygun {
 
 void VulkanContext::waitIdle()
 {
-    device->waitIdle();
+    // Queue by queue, each under its submit mutex. vkDeviceWaitIdle would
+    // require holding all of them.
+    graphicsQueue->waitIdle();
+    presentQueue->waitIdle();
+    computeQueue->waitIdle();
 }
 
-void VulkanContext::waitForFence(vk::Fence fence)
+void VulkanContext::runCompletedCallbacks()
 {
-    while(true) {
-        const auto result = device->waitForFences({fence}, true, 100);
-        if(result == vk::Result::eSuccess) break;
-        RAYGUN_ASSERT(result == vk::Result::eTimeout);
-    }
+    graphicsQueue->runCompletedCallbacks();
+    presentQueue->runCompletedCallbacks();
+    computeQueue->runCompletedCallbacks();
 }
 
 VulkanContext::VulkanContext()
@@ -65,12 +68,19 @@ VulkanContext::VulkanContext()
 
     setupQueues();
 
+    setupPipelineCache();
+
     RAYGUN_INFO("Vulkan context initialized");
 }
 
 VulkanContext::~VulkanContext()
 {
-    device->waitIdle();
+    waitIdle();
+
+    // Release retired resources while everything they depend on is alive.
+    runCompletedCallbacks();
+
+    pipelineCache->save();
 }
 
 void VulkanContext::setupInstance()
@@ -209,7 +219,7 @@ void VulkanContext::selectQueueFamily()
 
 void VulkanContext::setupDevice()
 {
-    const std::vector<const char*> extensions = {
+    std::vector<const char*> extensions = {
 #ifndef NDEBUG
         VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
 #endif
@@ -223,6 +233,24 @@ void VulkanContext::setupDevice()
         VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
     };
 
+    // Optional, used by the profiler to align GPU timestamps with CPU zones.
+    {
+        const auto available = physicalDevice.enumerateDeviceExtensionProperties();
+        const auto supported = std::any_of(available.begin(), available.end(), [](const auto& extension) {
+            return std::strcmp(extension.extensionName, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) == 0;
+        });
+
+        if(supported) {
+            const auto domains = physicalDevice.getCalibrateableTimeDomainsEXT();
+            const auto hasDomain = [&](vk::TimeDomainEXT domain) { return std::find(domains.begin(), domains.end(), domain) != domains.end(); };
+            calibratedTimestamps = hasDomain(vk::TimeDomainEXT::eDevice) && hasDomain(hostTimeDomain);
+        }
+
+        if(calibratedTimestamps) {
+            extensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+    }
+
     const float queuePriorities[] = {1.0f};
 
     std::vector<vk::DeviceQueueCreateInfo> queueInfos(2);
@@ -242,8 +270,12 @@ void VulkanContext::setupDevice()
         queueInfos.push_back(presentQueueInfo);
     }
 
+    vk::PhysicalDeviceTimelineSemaphoreFeatures timelineFeatures;
+    timelineFeatures.setTimelineSemaphore(true);
+
     vk::PhysicalDeviceBufferDeviceAddressFeatures addressFeatures;
     addressFeatures.setBufferDeviceAddress(true);
+    addressFeatures.setPNext(&timelineFeatures);
 
     vk::PhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructureFeatures;
     accelerationStructureFeatures.setAccelerationStructure(true);
@@ -269,14 +301,34 @@ void VulkanContext::setupDevice()
 
 void VulkanContext::setupQueues()
 {
-    graphicsQueue = std::make_unique<gpu::Queue>(*device, graphicsQueueFamilyIndex);
+    // Only the first queue of each family is used, hence wrappers of the same
+    // family refer to the same VkQueue and share its mutex.
+    std::map<uint32_t, std::shared_ptr<std::mutex>> submitMutexes;
+    const auto submitMutex = [&](uint32_t familyIndex) {
+        auto& mutex = submitMutexes[familyIndex];
+        if(!mutex) {
+            mutex = std::make_shared<std::mutex>();
+        }
+        return mutex;
+    };
+
+    graphicsQueue = std::make_unique<gpu::Queue>(*device, graphicsQueueFamilyIndex, submitMutex(graphicsQueueFamilyIndex));
     setObjectName(graphicsQueue->queue(), "Graphics Queue");
+    setObjectName(graphicsQueue->timeline(), "Graphics Queue Timeline");
 
-    presentQueue = std::make_unique<gpu::Queue>(*device, presentQueueFamilyIndex);
+    presentQueue = std::make_unique<gpu::Queue>(*device, presentQueueFamilyIndex, submitMutex(presentQueueFamilyIndex));
     setObjectName(presentQueue->queue(), "Present Queue");
+    setObjectName(presentQueue->timeline(), "Present Queue Timeline");
 
-    computeQueue = std::make_unique<gpu::Queue>(*device, computeQueueFamilyIndex);
+    computeQueue = std::make_unique<gpu::Queue>(*device, computeQueueFamilyIndex, submitMutex(computeQueueFamilyIndex));
     setObjectName(computeQueue->queue(), "Compute Queue");
+    setObjectName(computeQueue->timeline(), "Compute Queue Timeline");
+}
+
+void VulkanContext::setupPipelineCache()
+{
+    pipelineCache = std::make_unique<gpu::PipelineCache>(*device, physicalDeviceProperties, configDirectory() / "pipeline_cache.bin");
+    setObjectName(pipelineCache->cache(), "Pipeline Cache");
 }
 
 } // namespace raygun
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "raygun/gpu/gpu_queue.hpp"
+#include "raygun/gpu/pipeline_cache.hpp"
 #include "raygun/utils/vulkan_type_utils.hpp"
 #include "raygun/window.hpp"
 
@@ -59,11 +60,26 @@ class VulkanContext {
     gpu::UniqueQueue presentQueue;
     gpu::UniqueQueue computeQueue;
 
+    /// Used for all pipelines, persisted in the config directory.
+    gpu::UniquePipelineCache pipelineCache;
+
+    /// VK_EXT_calibrated_timestamps is enabled and supports the device and
+    /// host time domains.
+    bool calibratedTimestamps = false;
+
+    /// Host time domain of profiling::timestampNs (std::chrono::steady_clock).
+#ifdef _WIN32
+    static constexpr vk::TimeDomainEXT hostTimeDomain = vk::TimeDomainEXT::eQueryPerformanceCounter;
+#else
+    static constexpr vk::TimeDomainEXT hostTimeDomain = vk::TimeDomainEXT::eClockMonotonic;
+#endif
+
     //////////////////////////////////////////////////////////////////////////
 
     void waitIdle();
 
-    void waitForFence(vk::Fence fence);
+    /// Runs CPU work scheduled via Queue::onCompleted on all queues.
+    void runCompletedCallbacks();
 
     template<typename T>
     void setObjectName([[maybe_unused]] const T& object, [[maybe_unused]] string_view name)
@@ -99,6 +115,8 @@ class VulkanContext {
     void setupDevice();
 
     void setupQueues();
+
+    void setupPipelineCache();
 };
 
 using UniqueVulkanContext = std::unique_ptr<VulkanContext>;
@@ -62,6 +62,7 @@ Window::Window(string_view title)
 #endif
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    glfwWindowHint(GLFW_VISIBLE, config.hiddenWindow ? GLFW_FALSE : GLFW_TRUE);
 
     glfwWindowHint(GLFW_RED_BITS, mode->redBits);
     glfwWindowHint(GLFW_GREEN_BITS, mode->greenBits);
@@ -42,3 +42,10 @@ layout(binding = 11, set = 0, rgba16f) restrict uniform image2D roughColorsA;
 layout(binding = 12, set = 0) uniform sampler2D roughColorsASampler;
 layout(binding = 13, set = 0, rgba16f) restrict uniform image2D roughColorsB;
 layout(binding = 14, set = 0) uniform sampler2D roughColorsBSampler;
+
+layout(binding = 15, set = 0, rgba16f) restrict uniform image2D historyColor;
+layout(binding = 16, set = 0) uniform sampler2D historyColorSampler;
+layout(binding = 17, set = 0, rgba16f) restrict uniform image2D historyNormal;
+layout(binding = 18, set = 0) uniform sampler2D historyNormalSampler;
+layout(binding = 19, set = 0, rgba16f) restrict uniform image2D temporalOutput;
+layout(binding = 20, set = 0) uniform sampler2D temporalOutputSampler;
@@ -558,8 +558,12 @@ NOTE the other tuning knobs are now in the shader function inputs!
 /*--------------------------------------------------------------------------*/
 #if (FXAA_GLSL_130 == 1)
     // Requires "#version 130" or better
-    #define FxaaTexTop(t, p) textureLod(t, p, 0.0)
-    #define FxaaTexOff(t, p, o, r) textureLodOffset(t, p, 0.0, o)
+    #ifndef FxaaTexTop
+        #define FxaaTexTop(t, p) textureLod(t, p, 0.0)
+    #endif
+    #ifndef FxaaTexOff
+        #define FxaaTexOff(t, p, o, r) textureLodOffset(t, p, 0.0, o)
+    #endif
     #if (FXAA_GATHER4_ALPHA == 1)
         // use #extension GL_ARB_gpu_shader5 : enable
         #define FxaaTexAlpha4(t, p) textureGather(t, p, 3)
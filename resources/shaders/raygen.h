@@ -21,6 +21,7 @@
 // IN THE SOFTWARE.
 
 #include "raytracer_bindings.h"
+#include "temporal_shared.def"
 
 layout(binding = RAYGUN_RAYTRACER_BINDING_ACCELERATION_STRUCTURE, set = 0) uniform accelerationStructureEXT topLevelAS;
 layout(binding = RAYGUN_RAYTRACER_BINDING_OUTPUT_IMAGE, set = 0, rgba16f) restrict uniform image2D image;
@@ -82,7 +83,10 @@ mat3x4 traceRay(int numSamples)
     const float tmax = 10000.0;
 
     for(int i = 0; i < numSamples; ++i) {
-        const vec2 pixelCenter = vec2(gl_LaunchIDEXT.xy) + vec2(0.5) + vAAOffsets[min(numSamples, 8)][i % 8];
+        // With temporal accumulation a single sample is traced, jittered
+        // differently every frame.
+        const vec2 offset = ubo.temporal ? ubo.jitter : vAAOffsets[min(numSamples, 8)][i % 8];
+        const vec2 pixelCenter = vec2(gl_LaunchIDEXT.xy) + vec2(0.5) + offset;
         const vec2 inUV = pixelCenter / vec2(gl_LaunchSizeEXT.xy);
         const vec2 d = inUV * 2.0 - 1.0;
 
@@ -111,5 +115,5 @@ mat3x4 traceRay(int numSamples)
         depth += payload.depth;
     }
 
-    return mat3x4(vec4(color, reflectContrib), vec4(normal, log(depth) * 0.25), roughValue) / float(numSamples);
+    return mat3x4(vec4(color, reflectContrib), vec4(normal, log(depth) * TEMPORAL_DEPTH_SCALE), roughValue) / float(numSamples);
 }
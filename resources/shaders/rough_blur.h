@@ -23,6 +23,10 @@
 void main()
 {
     ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+    const ivec2 maxPos = ivec2(ubo.renderSize) - 1;
+    if(any(greaterThan(pos, maxPos))) {
+        return;
+    }
 
     float transition = imageLoad(roughTransitions, pos).r;
     if(transition < 0.001) {
@@ -31,8 +35,8 @@ void main()
 
     vec4 rough = imageLoad(IN_IMAGE, pos);
 
-    vec4 r_1 = imageLoad(IN_IMAGE, pos + OFFSET_1);
-    vec4 r_2 = imageLoad(IN_IMAGE, pos + OFFSET_2);
+    vec4 r_1 = imageLoad(IN_IMAGE, clamp(pos + OFFSET_1, ivec2(0), maxPos));
+    vec4 r_2 = imageLoad(IN_IMAGE, clamp(pos + OFFSET_2, ivec2(0), maxPos));
 
     vec3 col = rough.rgb * (1.f - transition - transition) + r_1.rgb * transition + r_2.rgb * transition;
 
@@ -0,0 +1,178 @@
+#include "raygun/raygun.hpp"
+
+using namespace raygun;
+using namespace raygun::physics;
+
+// Counts heap allocations made through operator new on the main thread.
+// Worker threads (shader compilation, asset loading) are not covered,
+// PhysX uses its own allocator.
+
+namespace {
+
+    std::atomic<uint64_t> allocations = 0;
+
+    thread_local bool countAllocations = false;
+
+    void* allocate(size_t size)
+    {
+        if(countAllocations) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if(const auto p = std::malloc(size ? size : 1)) {
+            return p;
+        }
+
+        throw std::bad_alloc();
+    }
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+    /// Frames skipped until caches, arenas and the physics scene have settled.
+    constexpr uint32_t WARMUP_FRAMES = 120;
+
+    constexpr uint32_t MEASURED_FRAMES = 300;
+
+    /// Spinning instances and falling balls in the room, covering transform
+    /// updates, physics write-back, the top level AS and rendering.
+    class AllocationScene : public Scene {
+      public:
+        AllocationScene()
+        {
+            auto level = RG().resourceManager().loadEntity("room");
+            level->forEachEntity([](Entity& entity) {
+                if(entity.model) {
+                    RG().physicsSystem().attachRigidStatic(entity, GeometryType::TriangleMesh);
+                }
+            });
+            root->addChild(level);
+
+            const auto model = RG().resourceManager().loadEntity("ball")->children().at(0)->model;
+
+            for(uint32_t i = 0; i < 64; ++i) {
+                auto ball = std::make_shared<Entity>("ball");
+                ball->model = model;
+                ball->moveTo({(float)(i % 8) - 4.0f, 2.0f + (float)(i / 8), (float)(i % 5) - 2.0f});
+
+                if(i % 2) {
+                    RG().physicsSystem().attachRigidDynamic(*ball, false, GeometryType::Sphere);
+                }
+                else {
+                    m_spinning.push_back(ball);
+                }
+
+                root->addChild(ball);
+            }
+
+            camera->moveTo({0.0f, 6.0f, 12.0f});
+            camera->lookAt(zero());
+        }
+
+        void preSimulation() override
+        {
+            const auto count = allocations.load(std::memory_order_relaxed);
+
+            if(m_frame > WARMUP_FRAMES && count != m_lastCount) {
+                m_framesWithAllocations++;
+                m_totalAllocations += count - m_lastCount;
+            }
+
+            m_lastCount = count;
+
+            if(++m_frame > WARMUP_FRAMES + MEASURED_FRAMES) {
+                RG().quit();
+            }
+        }
+
+        void update(double timeDelta) override
+        {
+            for(auto& entity: m_spinning) {
+                entity->rotate((float)timeDelta, UP);
+            }
+        }
+
+        uint32_t framesWithAllocations() const { return m_framesWithAllocations; }
+        uint64_t totalAllocations() const { return m_totalAllocations; }
+
+      private:
+        std::vector<std::shared_ptr<Entity>> m_spinning;
+
+        uint32_t m_framesWithAllocations = 0;
+        uint64_t m_totalAllocations = 0;
+
+        uint32_t m_frame = 0;
+        uint64_t m_lastCount = 0;
+    };
+
+    UniqueConfig testConfig()
+    {
+        auto config = std::make_unique<Config>();
+        config->fullscreen = Config::Fullscreen::Window;
+        config->presentMode = Config::PresentMode::Immediate;
+        config->width = 640;
+        config->height = 360;
+        config->hiddenWindow = true;
+        config->fixedTimeDelta = 1.0 / 60.0;
+        config->effectVolume = 0.0;
+        config->musicVolume = 0.0;
+
+        // Measured with CPU zones recorded, as shipped.
+        config->cpuProfiler = true;
+        return config;
+    }
+
+} // namespace
+
+int main()
+{
+    Raygun rg("Raygun Frame Allocations", testConfig());
+
+    auto scene = std::make_unique<AllocationScene>();
+    const auto& result = *scene;
+    rg.loadScene(std::move(scene));
+
+    countAllocations = true;
+    rg.loop();
+    countAllocations = false;
+
+    if(result.framesWithAllocations() > 0) {
+        fmt::print(stderr, "{} of {} frames allocated, {} allocations in total\n", result.framesWithAllocations(), MEASURED_FRAMES,
+                   result.totalAllocations());
+        return 1;
+    }
+
+    fmt::print("No allocations in {} frames\n", MEASURED_FRAMES);
+    return 0;
+}